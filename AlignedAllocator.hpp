@@ -0,0 +1,56 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Minimal allocator handing out storage aligned on Alignment bytes, so that
+// the particle arrays can be loaded with aligned SIMD instructions.
+template <typename Type, std::size_t Alignment = 32>
+class AlignedAllocator
+{
+
+public:
+
+    using value_type = Type;
+
+    template <typename Other>
+    struct rebind
+    {
+        using other = AlignedAllocator<Other, Alignment>;
+    };
+
+    AlignedAllocator() {}
+
+    template <typename Other>
+    AlignedAllocator(const AlignedAllocator<Other, Alignment>&) {}
+
+    Type* allocate(std::size_t n)
+    {
+        return static_cast<Type*>(::operator new(n * sizeof(Type), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(Type* p, std::size_t)
+    {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename Other>
+    bool operator== (const AlignedAllocator<Other, Alignment>&) const
+    {
+        return true;
+    }
+
+    template <typename Other>
+    bool operator!= (const AlignedAllocator<Other, Alignment>&) const
+    {
+        return false;
+    }
+};
+
+using FloatArray = std::vector<float, AlignedAllocator<float>>;
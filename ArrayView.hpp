@@ -0,0 +1,41 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+
+// Read-only view over contiguous elements owned by someone else. It stays
+// valid as long as the owner isn't resized or destroyed.
+template <typename Type>
+class ArrayView
+{
+
+public:
+
+    ArrayView() : m_data(nullptr), m_size(0) {}
+
+    ArrayView(const Type* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    template <typename Container>
+    ArrayView(const Container& container) : m_data(container.data()), m_size(container.size()) {}
+
+    inline const Type& operator[] (std::size_t idx) const
+    {
+        return m_data[idx];
+    }
+
+    const Type* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const Type* begin() const { return m_data; }
+    const Type* end() const { return m_data + m_size; }
+
+private:
+
+    const Type* m_data;
+    std::size_t m_size;
+};
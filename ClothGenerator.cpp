@@ -0,0 +1,206 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <math.h>
+
+#include "ClothGenerator.hpp"
+
+static inline void addConstraint(std::vector<Constraint>& constraints,
+                                 int idxA, int idxB, float restlength, float compliance)
+{
+    Constraint c;
+    c.idxA = idxA;
+    c.idxB = idxB;
+    c.restlength = restlength;
+    c.compliance = compliance;
+    constraints.push_back(c);
+}
+
+// Structural and shear constraints of the sub-grid made of every stride-th
+// particle, in the same order as the hand-written examples: rows, columns,
+// then both diagonals of each cell.
+static void addLattice(const ClothGridDesc& desc, int stride, bool structural, bool shear,
+                        std::vector<Constraint>& constraints)
+{
+    const int w = desc.width, h = desc.height;
+    const float length = stride * desc.spacing;
+    const float diagonal = stride * desc.spacing * sqrt(2.0f);
+
+    if(structural)
+    {
+        for(int j = 0; j < h; j += stride)
+        {
+            for(int i = 0; i + stride < w; i += stride)
+            {
+                addConstraint(constraints, j * w + i, j * w + i + stride, length, desc.structuralCompliance);
+            }
+        }
+
+        for(int j = 0; j + stride < h; j += stride)
+        {
+            for(int i = 0; i < w; i += stride)
+            {
+                addConstraint(constraints, j * w + i, (j + stride) * w + i, length, desc.structuralCompliance);
+            }
+        }
+    }
+
+    if(shear && stride == 1)
+    {
+        for(int j = 0; j + 1 < h; j++)
+        {
+            for(int i = 0; i + 1 < w; i++)
+            {
+                addConstraint(constraints, j * w + i, (j + 1) * w + i + 1, diagonal, desc.shearCompliance);
+            }
+        }
+
+        for(int j = 0; j + 1 < h; j++)
+        {
+            for(int i = 1; i < w; i++)
+            {
+                addConstraint(constraints, j * w + i, (j + 1) * w + i - 1, diagonal, desc.shearCompliance);
+            }
+        }
+    }
+    else if(shear)
+    {
+        for(int j = 0; j + stride < h; j += stride)
+        {
+            for(int i = 0; i + stride < w; i += stride)
+            {
+                addConstraint(constraints, j * w + i, (j + stride) * w + i + stride, diagonal, desc.shearCompliance);
+                addConstraint(constraints, j * w + i + stride, (j + stride) * w + i, diagonal, desc.shearCompliance);
+            }
+        }
+    }
+}
+
+static int latticeConstraintCount(int w, int h, int stride, bool structural, bool shear)
+{
+    int columns = (w - 1) / stride + 1;
+    int rows = (h - 1) / stride + 1;
+    int count = 0;
+
+    if(structural)
+    {
+        count += rows * (columns - 1) + (rows - 1) * columns;
+    }
+    if(shear)
+    {
+        count += 2 * (rows - 1) * (columns - 1);
+    }
+    return count;
+}
+
+static bool isPinned(int pinning, int i, int j, int w, int h)
+{
+    bool firstRow = j == 0, lastRow = j == h - 1;
+    bool corner = i == 0 || i == w - 1;
+
+    return ((pinning & PIN_FIRST_ROW) && firstRow) ||
+           ((pinning & PIN_LAST_ROW) && lastRow) ||
+           ((pinning & PIN_FIRST_COLUMN) && i == 0) ||
+           ((pinning & PIN_LAST_COLUMN) && i == w - 1) ||
+           ((pinning & PIN_FIRST_ROW_CORNERS) && firstRow && corner) ||
+           ((pinning & PIN_LAST_ROW_CORNERS) && lastRow && corner);
+}
+
+bool generateClothGrid(const ClothGridDesc& desc, ParticleBuffer& pos,
+                        FloatArray& invMass, std::vector<Constraint>& constraints,
+                        std::string& error)
+{
+    // sizes below 1 would wrap around when reserving the buffers
+    if(desc.width < 1 || desc.height < 1)
+    {
+        error = "cloth grid of " + std::to_string(desc.width) + " x " +
+                std::to_string(desc.height) + " particles is empty";
+        return false;
+    }
+    if(!(desc.spacing > 0.0f))
+    {
+        error = "cloth grid with a negative or invalid spacing";
+        return false;
+    }
+    if(!(desc.particleMass > 0.0f))
+    {
+        error = "cloth grid with a negative or invalid particle mass";
+        return false;
+    }
+
+    const int w = desc.width, h = desc.height;
+    const int numParticles = w * h;
+
+    pos.resize(numParticles);
+    invMass.resize(numParticles);
+
+    const float movableInvMass = 1.0f / desc.particleMass;
+    for(int j = 0; j < h; j++)
+    {
+        Vec3f rowStart = desc.origin + desc.rowAxis * (j * desc.spacing);
+
+        for(int i = 0; i < w; i++)
+        {
+            Vec3f p = rowStart + desc.columnAxis * (i * desc.spacing);
+            int idx = j * w + i;
+
+            pos.x[idx] = p[0];
+            pos.y[idx] = p[1];
+            pos.z[idx] = p[2];
+            invMass[idx] = isPinned(desc.pinning, i, j, w, h) ? 0.0f : movableInvMass;
+        }
+    }
+
+    bool coarse = desc.coarseStride > 1;
+    int numBend = (w > 2 ? h * (w - 2) : 0) + (h > 2 ? w * (h - 2) : 0);
+
+    constraints.clear();
+    constraints.reserve(latticeConstraintCount(w, h, 1, desc.structural, desc.shear) +
+                        (desc.bend ? numBend : 0) +
+                        (coarse ? latticeConstraintCount(w, h, desc.coarseStride, true, true) : 0));
+
+    addLattice(desc, 1, desc.structural, desc.shear, constraints);
+
+    if(desc.bend)
+    {
+        for(int j = 0; j < h; j++)
+        {
+            for(int i = 0; i + 2 < w; i++)
+            {
+                addConstraint(constraints, j * w + i, j * w + i + 2, 2.0f * desc.spacing, desc.bendCompliance);
+            }
+        }
+
+        for(int j = 0; j + 2 < h; j++)
+        {
+            for(int i = 0; i < w; i++)
+            {
+                addConstraint(constraints, j * w + i, (j + 2) * w + i, 2.0f * desc.spacing, desc.bendCompliance);
+            }
+        }
+    }
+
+    if(coarse)
+    {
+        addLattice(desc, desc.coarseStride, true, true, constraints);
+    }
+    return true;
+}
+
+bool generateClothGrid(const ClothGridDesc& desc, ClothSimulationSystem& system,
+                        std::string& error)
+{
+    ParticleBuffer pos;
+    FloatArray invMass;
+    std::vector<Constraint> constraints;
+
+    if(!generateClothGrid(desc, pos, invMass, constraints, error))
+    {
+        return false;
+    }
+
+    system = ClothSimulationSystem(std::move(pos), std::move(invMass), std::move(constraints));
+    return true;
+}
@@ -0,0 +1,64 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ClothSimulationSystem.hpp"
+#include "ParticleBuffer.hpp"
+#include "Vec3.hpp"
+
+// Which particles of a generated grid can't move. Flags can be combined.
+enum ClothPinning {
+    PIN_NONE = 0,
+    PIN_FIRST_ROW = 1 << 0,
+    PIN_LAST_ROW = 1 << 1,
+    PIN_FIRST_COLUMN = 1 << 2,
+    PIN_LAST_COLUMN = 1 << 3,
+    PIN_FIRST_ROW_CORNERS = 1 << 4,
+    PIN_LAST_ROW_CORNERS = 1 << 5
+};
+
+// Description of a width x height grid of particles. Particle (i, j), at
+// index j * width + i, sits at origin + (columnAxis * i + rowAxis * j) * spacing.
+struct ClothGridDesc {
+    int width = 2, height = 2;
+    float spacing = 1.0f;
+    Vec3f origin = Vec3f(0.0f, 0.0f, 0.0f);
+    Vec3f columnAxis = Vec3f(1.0f, 0.0f, 0.0f);
+    Vec3f rowAxis = Vec3f(0.0f, -1.0f, 0.0f);
+    float particleMass = 1.0f;
+    int pinning = PIN_FIRST_ROW;
+
+    // neighbours along rows and columns
+    bool structural = true;
+    // both diagonals of every grid cell
+    bool shear = false;
+    // every other neighbour along rows and columns
+    bool bend = false;
+    // if > 1, structural and shear constraints are also added between the
+    // particles whose coordinates are multiples of this stride, as a coarser
+    // grid laid over the cloth to make it stiffer
+    int coarseStride = 0;
+
+    // compliance of each kind of constraint, coarse ones included; only
+    // the XPBD solver reads them
+    float structuralCompliance = 0.0f;
+    float shearCompliance = 0.0f;
+    float bendCompliance = 0.0f;
+};
+
+// Builds the grid straight into structure-of-arrays buffers, reserved up
+// front from the exact particle and constraint counts. Returns false, with
+// the reason in error, for a grid without particles or with a non-positive
+// spacing or particle mass.
+bool generateClothGrid(const ClothGridDesc& desc, ParticleBuffer& pos,
+                        FloatArray& invMass, std::vector<Constraint>& constraints,
+                        std::string& error);
+
+bool generateClothGrid(const ClothGridDesc& desc, ClothSimulationSystem& system,
+                        std::string& error);
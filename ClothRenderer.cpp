@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#define GL_GLEXT_PROTOTYPES
+
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+#include "ClothRenderer.hpp"
+
+ClothRenderer::ClothRenderer()
+{
+    m_vertexBuffer = m_indexBuffer = 0;
+    m_numIndices = 0;
+    m_numParticles = 0;
+}
+
+void ClothRenderer::Release()
+{
+    if(m_vertexBuffer)
+    {
+        glDeleteBuffers(1, &m_vertexBuffer);
+        glDeleteBuffers(1, &m_indexBuffer);
+    }
+
+    m_vertexBuffer = m_indexBuffer = 0;
+    m_numIndices = 0;
+    m_numParticles = 0;
+}
+
+void ClothRenderer::Load(const ClothSimulationSystem& system)
+{
+    if(!m_vertexBuffer)
+    {
+        glGenBuffers(1, &m_vertexBuffer);
+        glGenBuffers(1, &m_indexBuffer);
+    }
+
+    // original numbering, the one copyPositions() writes the particles in
+    std::vector<Constraint> constraints = system.getConstraints();
+    std::vector<GLuint> indices(2 * constraints.size());
+    for(unsigned int i = 0; i < constraints.size(); i++)
+    {
+        indices[2 * i + 0] = constraints[i].idxA;
+        indices[2 * i + 1] = constraints[i].idxB;
+    }
+
+    m_numIndices = indices.size();
+    m_numParticles = system.getNumParticles();
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint),
+                 indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, 3 * m_numParticles * sizeof(float), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ClothRenderer::Draw(const ClothSimulationSystem& system)
+{
+    if(system.getNumParticles() == m_numParticles)
+    {
+        DrawPositions([&](float* xyz) { system.copyPositions(xyz); });
+    }
+}
+
+void ClothRenderer::Draw(FrameCacheReader& cache, int frame)
+{
+    if(static_cast<unsigned int>(cache.getNumParticles()) == m_numParticles &&
+       frame >= 0 && frame < cache.getNumFrames())
+    {
+        DrawPositions([&](float* xyz) { cache.DecodeFrame(frame, xyz); });
+    }
+}
+
+void ClothRenderer::DrawPositions(const std::function<void(float*)>& writePositions)
+{
+    if(!m_vertexBuffer || m_numIndices == 0)
+    {
+        return;
+    }
+
+    const GLsizeiptr size = 3 * m_numParticles * sizeof(float);
+
+    // orphan last frame's storage so the driver doesn't have to wait until
+    // it's done drawing from it, then write the new positions in place
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+
+    float* mapped = static_cast<float*>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
+    if(mapped)
+    {
+        writePositions(mapped);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    else
+    {
+        m_staging.resize(3 * m_numParticles);
+        writePositions(m_staging.data());
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, m_staging.data());
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+
+    glColor3d(0.85f,0.42,0.44);
+    glDrawElements(GL_LINES, m_numIndices, GL_UNSIGNED_INT, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
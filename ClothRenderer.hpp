@@ -0,0 +1,51 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <GL/gl.h>
+
+#include "ClothSimulationSystem.hpp"
+#include "FrameCache.hpp"
+
+// Draws every constraint of a cloth as a line, from buffer objects: the
+// constraint indices are uploaded once per scene, the positions are streamed
+// into one vertex buffer per frame, and the whole cloth is one glDrawElements
+// call. Only needs OpenGL 1.5, so it runs on Mesa's llvmpipe as well.
+// Buffers are not freed by the destructor: a renderer kept in a static
+// outlives the GL context, so Release() has to be called while it exists.
+class ClothRenderer
+{
+
+public:
+
+    ClothRenderer();
+
+    ClothRenderer(const ClothRenderer&) = delete;
+    ClothRenderer& operator= (const ClothRenderer&) = delete;
+
+    // Uploads the constraint index buffer. Needs a current GL context, and
+    // has to be called again whenever another scene is loaded.
+    void Load(const ClothSimulationSystem& system);
+    void Draw(const ClothSimulationSystem& system);
+    // Draws a recorded frame of the loaded scene.
+    void Draw(FrameCacheReader& cache, int frame);
+    // Deletes the buffers. Needs the GL context Load() used to be current.
+    void Release();
+
+private:
+
+    GLuint m_vertexBuffer, m_indexBuffer;
+    GLsizei m_numIndices;
+    unsigned int m_numParticles;
+
+    // only used if the vertex buffer can't be mapped
+    std::vector<float> m_staging;
+
+    void DrawPositions(const std::function<void(float*)>& writePositions);
+};
@@ -0,0 +1,488 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 15/11/2018
+//-----------------------------------------------------------------------------
+
+#include <math.h>
+#include <stdlib.h>
+#include <iostream>
+
+#include "ClothGenerator.hpp"
+#include "ClothScenes.hpp"
+
+static const ClothScene scenes[] = {
+    { "string", "string example", createStringExample },
+    { "cube", "cube example", createCubeExample },
+    { "fixed-string", "fixed string example", createFixedStringExample },
+    { "fixed-cube", "fixed cube example", createFixedCubeExample },
+    { "fixed-strong-cube", "strong fixed cube example", createFixedStrongCubeExample },
+    { "fixed-extra-strong-cube", "extra strong fixed cube example", createFixedExtraStrongCubeExample },
+    { "cloth-patch", "cloth patch example", createClothPatchExample },
+    { "strong-cloth-patch", "strong cloth patch example", createStrongClothPatchExample },
+    { "extra-strong-cloth-patch", "extra strong cloth patch example", createExtraStrongClothPatchExample },
+    { "compressed-string", "compressed string example", createCompressedStringExample },
+    { "large-cloth-patch", "large cloth patch example", createLargeClothPatchExample },
+};
+
+const ClothScene* getClothScenes(int& numScenes)
+{
+    numScenes = sizeof(scenes) / sizeof(scenes[0]);
+    return scenes;
+}
+
+const ClothScene* findClothScene(const std::string& name)
+{
+    for(const ClothScene& scene : scenes)
+    {
+        if(name == scene.name)
+        {
+            return &scene;
+        }
+    }
+    return nullptr;
+}
+
+Vec3f getWindForce()
+{
+    // https://stackoverflow.com/questions/686353/c-random-float-number-generation
+    // random number from 0 to 10
+    float randX = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/10.0f));
+    float randY = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/10.0f));
+    float randZ = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX/10.0f));
+    return Vec3f(randX, randY, randZ);
+}
+
+void stepScene(ClothSimulationSystem& system, float deltaTime, bool wind)
+{
+    Vec3f gravity = Vec3f(0.0f, -9.81f, 0.0f);
+
+    if(wind)
+    {
+        system.ApplyForce(getWindForce());
+    }
+
+    system.ApplyForce(gravity);
+    system.TimeStep(deltaTime);
+}
+
+void stepScene(ClothWorld& world, float deltaTime, bool wind)
+{
+    Vec3f gravity = Vec3f(0.0f, -9.81f, 0.0f);
+
+    for(unsigned int i = 0; i < world.getNumCloths() && wind; i++)
+    {
+        world.getCloth(i).ApplyForce(getWindForce());
+    }
+
+    world.ApplyForce(gravity);
+    world.TimeStep(deltaTime);
+}
+
+ClothSimulationSystem createStringExample()
+{
+    std::vector<Vec3f> pos;
+    pos.push_back(Vec3f(0.0f, 0.0f, 0.0f));
+    pos.push_back(Vec3f(1.0f, 1.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 2.0f, 2.0f));
+    pos.push_back(Vec3f(3.0f, 3.0f, 3.0f));
+    pos.push_back(Vec3f(4.0f, 4.0f, 4.0f));
+
+    std::vector<Constraint> constraints;
+    Constraint c0, c1, c2, c3;
+    c0.idxA = 0; c0.idxB = 1; c0.restlength = sqrt(3.0f);
+    c1.idxA = 1; c1.idxB = 2; c1.restlength = sqrt(3.0f);
+    c2.idxA = 2; c2.idxB = 3; c2.restlength = sqrt(3.0f);
+    c3.idxA = 3; c3.idxB = 4; c3.restlength = sqrt(3.0f);
+    constraints.push_back(c0);
+    constraints.push_back(c1);
+    constraints.push_back(c2);
+    constraints.push_back(c3);
+
+    std::vector<bool> isMovable;
+    isMovable.resize(5);
+    isMovable[0] = true;
+    isMovable[1] = true;
+    isMovable[2] = true;
+    isMovable[3] = true;
+    isMovable[4] = true;
+
+    return ClothSimulationSystem(pos, constraints, isMovable);
+}
+
+ClothSimulationSystem createCompressedStringExample()
+{
+    std::vector<Vec3f> pos;
+    pos.push_back(Vec3f(0.0f, 0.0f, 0.0f));
+    pos.push_back(Vec3f(1.0f, 1.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 2.0f, 2.0f));
+    pos.push_back(Vec3f(3.0f, 3.0f, 3.0f));
+    pos.push_back(Vec3f(4.0f, 4.0f, 4.0f));
+
+    std::vector<Constraint> constraints;
+    Constraint c0, c1, c2, c3;
+    c0.idxA = 0; c0.idxB = 1; c0.restlength = 3.0f;
+    c1.idxA = 1; c1.idxB = 2; c1.restlength = 3.0f;
+    c2.idxA = 2; c2.idxB = 3; c2.restlength = 3.0f;
+    c3.idxA = 3; c3.idxB = 4; c3.restlength = 3.0f;
+    constraints.push_back(c0);
+    constraints.push_back(c1);
+    constraints.push_back(c2);
+    constraints.push_back(c3);
+
+    std::vector<bool> isMovable;
+    isMovable.resize(5);
+    isMovable[0] = true;
+    isMovable[1] = true;
+    isMovable[2] = true;
+    isMovable[3] = true;
+    isMovable[4] = true;
+
+    return ClothSimulationSystem(pos, constraints, isMovable);
+}
+
+ClothSimulationSystem createCubeExample()
+{
+    std::vector<Vec3f> pos;
+    pos.push_back(Vec3f(1.0f, 1.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 1.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 2.0f, 1.0f));
+    pos.push_back(Vec3f(1.0f, 2.0f, 1.0f));
+    pos.push_back(Vec3f(1.0f, 1.0f, 2.0f));
+    pos.push_back(Vec3f(2.0f, 1.0f, 2.0f));
+    pos.push_back(Vec3f(2.0f, 2.0f, 2.0f));
+    pos.push_back(Vec3f(1.0f, 2.0f, 2.0f));
+
+    std::vector<Constraint> constraints;
+    Constraint c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11;
+    c0.idxA = 0; c0.idxB = 1; c0.restlength = 1.0f;
+    c1.idxA = 1; c1.idxB = 2; c1.restlength = 1.0f;
+    c2.idxA = 2; c2.idxB = 3; c2.restlength = 1.0f;
+    c3.idxA = 3; c3.idxB = 0; c3.restlength = 1.0f;
+    c4.idxA = 0; c4.idxB = 4; c4.restlength = 1.0f;
+    c5.idxA = 1; c5.idxB = 5; c5.restlength = 1.0f;
+    c6.idxA = 2; c6.idxB = 6; c6.restlength = 1.0f;
+    c7.idxA = 3; c7.idxB = 7; c7.restlength = 1.0f;
+    c8.idxA = 4; c8.idxB = 5; c8.restlength = 1.0f;
+    c9.idxA = 5; c9.idxB = 6; c9.restlength = 1.0f;
+    c10.idxA = 6; c10.idxB = 7; c10.restlength = 1.0f;
+    c11.idxA = 7; c11.idxB = 4; c11.restlength = 1.0f;
+    constraints.push_back(c0);
+    constraints.push_back(c1);
+    constraints.push_back(c2);
+    constraints.push_back(c3);
+    constraints.push_back(c4);
+    constraints.push_back(c5);
+    constraints.push_back(c6);
+    constraints.push_back(c7);
+    constraints.push_back(c8);
+    constraints.push_back(c9);
+    constraints.push_back(c10);
+    constraints.push_back(c11);
+
+    std::vector<bool> isMovable;
+    isMovable.resize(8);
+    isMovable[0] = true;
+    isMovable[1] = true;
+    isMovable[2] = true;
+    isMovable[3] = true;
+    isMovable[4] = true;
+    isMovable[5] = true;
+    isMovable[6] = true;
+    isMovable[7] = true;
+
+    return ClothSimulationSystem(pos, constraints, isMovable);
+}
+
+ClothSimulationSystem createFixedStringExample()
+{
+    std::vector<Vec3f> pos;
+    pos.push_back(Vec3f(0.0f, 3.0f, 0.0f));
+    pos.push_back(Vec3f(1.0f, 4.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 5.0f, 2.0f));
+    pos.push_back(Vec3f(3.0f, 6.0f, 3.0f));
+    pos.push_back(Vec3f(4.0f, 7.0f, 4.0f));
+
+    std::vector<Constraint> constraints;
+    Constraint c0, c1, c2, c3;
+    c0.idxA = 0; c0.idxB = 1; c0.restlength = sqrt(3.0f);
+    c1.idxA = 1; c1.idxB = 2; c1.restlength = sqrt(3.0f);
+    c2.idxA = 2; c2.idxB = 3; c2.restlength = sqrt(3.0f);
+    c3.idxA = 3; c3.idxB = 4; c3.restlength = sqrt(3.0f);
+    constraints.push_back(c0);
+    constraints.push_back(c1);
+    constraints.push_back(c2);
+    constraints.push_back(c3);
+
+    std::vector<bool> isMovable;
+    isMovable.resize(5);
+    isMovable[0] = true;
+    isMovable[1] = true;
+    isMovable[2] = true;
+    isMovable[3] = true;
+    isMovable[4] = false;
+
+    return ClothSimulationSystem(pos, constraints, isMovable);
+}
+
+ClothSimulationSystem createFixedCubeExample()
+{
+    std::vector<Vec3f> pos;
+    pos.push_back(Vec3f(1.0f, 1.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 1.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 2.0f, 1.0f));
+    pos.push_back(Vec3f(1.0f, 2.0f, 1.0f));
+    pos.push_back(Vec3f(1.0f, 1.0f, 2.0f));
+    pos.push_back(Vec3f(2.0f, 1.0f, 2.0f));
+    pos.push_back(Vec3f(2.0f, 2.0f, 2.0f));
+    pos.push_back(Vec3f(1.0f, 2.0f, 2.0f));
+
+    std::vector<Constraint> constraints;
+    Constraint c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11;
+    c0.idxA = 0; c0.idxB = 1; c0.restlength = 1.0f;
+    c1.idxA = 1; c1.idxB = 2; c1.restlength = 1.0f;
+    c2.idxA = 2; c2.idxB = 3; c2.restlength = 1.0f;
+    c3.idxA = 3; c3.idxB = 0; c3.restlength = 1.0f;
+    c4.idxA = 0; c4.idxB = 4; c4.restlength = 1.0f;
+    c5.idxA = 1; c5.idxB = 5; c5.restlength = 1.0f;
+    c6.idxA = 2; c6.idxB = 6; c6.restlength = 1.0f;
+    c7.idxA = 3; c7.idxB = 7; c7.restlength = 1.0f;
+    c8.idxA = 4; c8.idxB = 5; c8.restlength = 1.0f;
+    c9.idxA = 5; c9.idxB = 6; c9.restlength = 1.0f;
+    c10.idxA = 6; c10.idxB = 7; c10.restlength = 1.0f;
+    c11.idxA = 7; c11.idxB = 4; c11.restlength = 1.0f;
+    constraints.push_back(c0);
+    constraints.push_back(c1);
+    constraints.push_back(c2);
+    constraints.push_back(c3);
+    constraints.push_back(c4);
+    constraints.push_back(c5);
+    constraints.push_back(c6);
+    constraints.push_back(c7);
+    constraints.push_back(c8);
+    constraints.push_back(c9);
+    constraints.push_back(c10);
+    constraints.push_back(c11);
+
+    std::vector<bool> isMovable;
+    isMovable.resize(8);
+    isMovable[0] = true;
+    isMovable[1] = true;
+    isMovable[2] = true;
+    isMovable[3] = false;
+    isMovable[4] = true;
+    isMovable[5] = true;
+    isMovable[6] = true;
+    isMovable[7] = true;
+
+    return ClothSimulationSystem(pos, constraints, isMovable);
+}
+
+ClothSimulationSystem createFixedStrongCubeExample()
+{
+    std::vector<Vec3f> pos;
+    pos.push_back(Vec3f(1.0f, 1.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 1.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 2.0f, 1.0f));
+    pos.push_back(Vec3f(1.0f, 2.0f, 1.0f));
+    pos.push_back(Vec3f(1.0f, 1.0f, 2.0f));
+    pos.push_back(Vec3f(2.0f, 1.0f, 2.0f));
+    pos.push_back(Vec3f(2.0f, 2.0f, 2.0f));
+    pos.push_back(Vec3f(1.0f, 2.0f, 2.0f));
+
+    std::vector<Constraint> constraints;
+    Constraint c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11;
+    c0.idxA = 0; c0.idxB = 1; c0.restlength = 1.0f;
+    c1.idxA = 1; c1.idxB = 2; c1.restlength = 1.0f;
+    c2.idxA = 2; c2.idxB = 3; c2.restlength = 1.0f;
+    c3.idxA = 3; c3.idxB = 0; c3.restlength = 1.0f;
+    c4.idxA = 0; c4.idxB = 4; c4.restlength = 1.0f;
+    c5.idxA = 1; c5.idxB = 5; c5.restlength = 1.0f;
+    c6.idxA = 2; c6.idxB = 6; c6.restlength = 1.0f;
+    c7.idxA = 3; c7.idxB = 7; c7.restlength = 1.0f;
+    c8.idxA = 4; c8.idxB = 5; c8.restlength = 1.0f;
+    c9.idxA = 5; c9.idxB = 6; c9.restlength = 1.0f;
+    c10.idxA = 6; c10.idxB = 7; c10.restlength = 1.0f;
+    c11.idxA = 7; c11.idxB = 4; c11.restlength = 1.0f;
+    constraints.push_back(c0);
+    constraints.push_back(c1);
+    constraints.push_back(c2);
+    constraints.push_back(c3);
+    constraints.push_back(c4);
+    constraints.push_back(c5);
+    constraints.push_back(c6);
+    constraints.push_back(c7);
+    constraints.push_back(c8);
+    constraints.push_back(c9);
+    constraints.push_back(c10);
+    constraints.push_back(c11);
+
+    // diagonal constraints
+    Constraint d0, d1, d2, d3;
+    d0.idxA = 0; d0.idxB = 6; d0.restlength = sqrt(3.0f);
+    d1.idxA = 1; d1.idxB = 7; d1.restlength = sqrt(3.0f);
+    d2.idxA = 2; d2.idxB = 4; d2.restlength = sqrt(3.0f);
+    d3.idxA = 3; d3.idxB = 5; d3.restlength = sqrt(3.0f);
+    constraints.push_back(d0);
+    constraints.push_back(d1);
+    constraints.push_back(d2);
+    constraints.push_back(d3);
+
+    std::vector<bool> isMovable;
+    isMovable.resize(8);
+    isMovable[0] = true;
+    isMovable[1] = true;
+    isMovable[2] = true;
+    isMovable[3] = false;
+    isMovable[4] = true;
+    isMovable[5] = true;
+    isMovable[6] = true;
+    isMovable[7] = true;
+
+    return ClothSimulationSystem(pos, constraints, isMovable);
+}
+
+ClothSimulationSystem createFixedExtraStrongCubeExample()
+{
+    std::vector<Vec3f> pos;
+    pos.push_back(Vec3f(1.0f, 1.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 1.0f, 1.0f));
+    pos.push_back(Vec3f(2.0f, 2.0f, 1.0f));
+    pos.push_back(Vec3f(1.0f, 2.0f, 1.0f));
+    pos.push_back(Vec3f(1.0f, 1.0f, 2.0f));
+    pos.push_back(Vec3f(2.0f, 1.0f, 2.0f));
+    pos.push_back(Vec3f(2.0f, 2.0f, 2.0f));
+    pos.push_back(Vec3f(1.0f, 2.0f, 2.0f));
+
+    std::vector<Constraint> constraints;
+    Constraint c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11;
+    c0.idxA = 0; c0.idxB = 1; c0.restlength = 1.0f;
+    c1.idxA = 1; c1.idxB = 2; c1.restlength = 1.0f;
+    c2.idxA = 2; c2.idxB = 3; c2.restlength = 1.0f;
+    c3.idxA = 3; c3.idxB = 0; c3.restlength = 1.0f;
+    c4.idxA = 0; c4.idxB = 4; c4.restlength = 1.0f;
+    c5.idxA = 1; c5.idxB = 5; c5.restlength = 1.0f;
+    c6.idxA = 2; c6.idxB = 6; c6.restlength = 1.0f;
+    c7.idxA = 3; c7.idxB = 7; c7.restlength = 1.0f;
+    c8.idxA = 4; c8.idxB = 5; c8.restlength = 1.0f;
+    c9.idxA = 5; c9.idxB = 6; c9.restlength = 1.0f;
+    c10.idxA = 6; c10.idxB = 7; c10.restlength = 1.0f;
+    c11.idxA = 7; c11.idxB = 4; c11.restlength = 1.0f;
+    constraints.push_back(c0);
+    constraints.push_back(c1);
+    constraints.push_back(c2);
+    constraints.push_back(c3);
+    constraints.push_back(c4);
+    constraints.push_back(c5);
+    constraints.push_back(c6);
+    constraints.push_back(c7);
+    constraints.push_back(c8);
+    constraints.push_back(c9);
+    constraints.push_back(c10);
+    constraints.push_back(c11);
+
+    // diagonal constraints
+    Constraint d0, d1, d2, d3;
+    d0.idxA = 0; d0.idxB = 6; d0.restlength = sqrt(3.0f);
+    d1.idxA = 1; d1.idxB = 7; d1.restlength = sqrt(3.0f);
+    d2.idxA = 2; d2.idxB = 4; d2.restlength = sqrt(3.0f);
+    d3.idxA = 3; d3.idxB = 5; d3.restlength = sqrt(3.0f);
+    constraints.push_back(d0);
+    constraints.push_back(d1);
+    constraints.push_back(d2);
+    constraints.push_back(d3);
+
+    // side diagonal constraints
+    Constraint s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11;
+    s0.idxA = 0; s0.idxB = 2; s0.restlength = sqrt(2.0f);
+    s1.idxA = 1; s1.idxB = 3; s1.restlength = sqrt(2.0f);
+    s2.idxA = 1; s2.idxB = 6; s2.restlength = sqrt(2.0f);
+    s3.idxA = 5; s3.idxB = 2; s3.restlength = sqrt(2.0f);
+    s4.idxA = 5; s4.idxB = 7; s4.restlength = sqrt(2.0f);
+    s5.idxA = 4; s5.idxB = 6; s5.restlength = sqrt(2.0f);
+    s6.idxA = 4; s6.idxB = 3; s6.restlength = sqrt(2.0f);
+    s7.idxA = 0; s7.idxB = 7; s7.restlength = sqrt(2.0f);
+    s8.idxA = 0; s8.idxB = 5; s8.restlength = sqrt(2.0f);
+    s9.idxA = 1; s9.idxB = 4; s9.restlength = sqrt(2.0f);
+    s10.idxA = 2; s10.idxB = 7; s10.restlength = sqrt(2.0f);
+    s11.idxA = 3; s11.idxB = 6; s11.restlength = sqrt(2.0f);
+    constraints.push_back(s0);
+    constraints.push_back(s1);
+    constraints.push_back(s2);
+    constraints.push_back(s3);
+    constraints.push_back(s4);
+    constraints.push_back(s5);
+    constraints.push_back(s6);
+    constraints.push_back(s7);
+    constraints.push_back(s8);
+    constraints.push_back(s9);
+    constraints.push_back(s10);
+    constraints.push_back(s11);
+
+    std::vector<bool> isMovable;
+    isMovable.resize(8);
+    isMovable[0] = true;
+    isMovable[1] = true;
+    isMovable[2] = true;
+    isMovable[3] = false;
+    isMovable[4] = true;
+    isMovable[5] = true;
+    isMovable[6] = true;
+    isMovable[7] = true;
+
+    return ClothSimulationSystem(pos, constraints, isMovable);
+}
+
+// 7x7 patch hanging from its left edge
+static ClothGridDesc clothPatchDesc()
+{
+    ClothGridDesc desc;
+    desc.width = 7;
+    desc.height = 7;
+    desc.origin = Vec3f(-3.0f, 10.0f, 0.0f);
+    desc.pinning = PIN_FIRST_COLUMN;
+    return desc;
+}
+
+static ClothSimulationSystem createGrid(const ClothGridDesc& desc)
+{
+    ClothSimulationSystem clothSystem;
+    std::string error;
+    if(!generateClothGrid(desc, clothSystem, error))
+    {
+        std::cerr << "Error: " << error << "." << std::endl;
+    }
+    return clothSystem;
+}
+
+ClothSimulationSystem createClothPatchExample()
+{
+    return createGrid(clothPatchDesc());
+}
+
+ClothSimulationSystem createStrongClothPatchExample()
+{
+    ClothGridDesc desc = clothPatchDesc();
+    desc.shear = true;
+    return createGrid(desc);
+}
+
+ClothSimulationSystem createExtraStrongClothPatchExample()
+{
+    ClothGridDesc desc = clothPatchDesc();
+    desc.shear = true;
+    desc.coarseStride = 2;
+    return createGrid(desc);
+}
+
+ClothSimulationSystem createLargeClothPatchExample()
+{
+    ClothGridDesc desc;
+    desc.width = 100;
+    desc.height = 100;
+    desc.spacing = 0.1f;
+    desc.origin = Vec3f(-5.0f, 12.0f, 0.0f);
+    desc.pinning = PIN_FIRST_ROW_CORNERS;
+    desc.shear = true;
+    desc.bend = true;
+    return createGrid(desc);
+}
@@ -0,0 +1,45 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 15/11/2018
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+
+#include "ClothSimulationSystem.hpp"
+#include "ClothWorld.hpp"
+#include "Vec3.hpp"
+
+// Example scenes. Nothing in here depends on OpenGL, so they can be used
+// both by the viewer and by the headless tools.
+
+ClothSimulationSystem createStringExample();
+ClothSimulationSystem createCompressedStringExample();
+ClothSimulationSystem createCubeExample();
+ClothSimulationSystem createFixedStringExample();
+ClothSimulationSystem createFixedCubeExample();
+ClothSimulationSystem createFixedStrongCubeExample();
+ClothSimulationSystem createFixedExtraStrongCubeExample();
+ClothSimulationSystem createClothPatchExample();
+ClothSimulationSystem createStrongClothPatchExample();
+ClothSimulationSystem createExtraStrongClothPatchExample();
+ClothSimulationSystem createLargeClothPatchExample();
+
+struct ClothScene {
+    const char* name;
+    const char* description;
+    ClothSimulationSystem (*create)();
+};
+
+const ClothScene* getClothScenes(int& numScenes);
+// nullptr if there is no scene with this name
+const ClothScene* findClothScene(const std::string& name);
+
+// random force from 0 to 10 in each direction
+Vec3f getWindForce();
+
+// Applies gravity (and wind if enabled) then advances the simulation.
+void stepScene(ClothSimulationSystem& system, float deltaTime, bool wind);
+// Same for every cloth of a world, each with its own wind.
+void stepScene(ClothWorld& world, float deltaTime, bool wind);
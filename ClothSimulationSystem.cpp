@@ -6,17 +6,56 @@
 //---------------------------------------------------------------------------------------
 
 #include <math.h>
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
 
 #include "ClothSimulationSystem.hpp"
-#include "Camera.hpp"
+#include "Profiler.hpp"
+#include "SimdKernels.hpp"
 
 static const float particleMass = 1.0f;
 
-static const int numRelaxIter = 5;
+// Self-collision pairs are gathered up to this fraction of the thickness
+// further apart, to catch the ones that come into contact while relaxing.
+static const float collisionMargin = 0.5f;
+// Particles per block of the self-collision search. Blocks don't depend on
+// the number of threads, so neither does the order pairs are found in.
+static const int collisionBlockSize = 4096;
+// Smallest chunk of particles or constraints handed to a thread by the
+// parallel loops, below which waking threads up costs more than it saves.
+static const int parallelGrainSize = 1024;
+// Largest cloth whose constraints are packed with 16-bit indices.
+static const unsigned int maxNarrowParticles = 65536;
+// Multigrid: coarsening stops at this many particles, and each coarse level
+// is relaxed this many times per pass.
+static const int minCoarseParticles = 64;
+static const int coarseSweeps = 2;
 
-ClothSimulationSystem::ClothSimulationSystem()
+static const char* const solverNames[] = { "gauss-seidel", "colored", "jacobi", "xpbd", "multigrid" };
+
+bool parseConstraintSolver(const std::string& name, ConstraintSolver& solver)
 {
+    for(unsigned int i = 0; i < sizeof(solverNames) / sizeof(solverNames[0]); i++)
+    {
+        if(name == solverNames[i])
+        {
+            solver = static_cast<ConstraintSolver>(i);
+            return true;
+        }
+    }
+    return false;
+}
 
+const char* getConstraintSolverName(ConstraintSolver solver)
+{
+    return solverNames[static_cast<int>(solver)];
+}
+
+ClothSimulationSystem::ClothSimulationSystem()
+{
+    Initialize();
 }
 
 ClothSimulationSystem::ClothSimulationSystem(std::vector<Vec3f>& pos,
@@ -25,108 +64,1316 @@ ClothSimulationSystem::ClothSimulationSystem(std::vector<Vec3f>& pos,
 {
     int numParticles = pos.size();
 
-    m_currPos = pos;
     m_constraints = constraints;
-    m_isMovable = isMovable;
-    
-    m_oldPos.resize(numParticles);
-    m_forces.resize(numParticles);
 
-    for(unsigned int i = 0; i < m_currPos.size(); i++)
+    m_currPos.resize(numParticles);
+    m_invMass.resize(numParticles);
+
+    for(int i = 0; i < numParticles; i++)
     {
-        m_oldPos[i] = m_currPos[i];
-        m_forces[i] = Vec3f(0.0f, 0.0f, 0.0f);
+        m_currPos.x[i] = pos[i][0];
+        m_currPos.y[i] = pos[i][1];
+        m_currPos.z[i] = pos[i][2];
+        m_invMass[i] = isMovable[i] ? 1.0f / particleMass : 0.0f;
     }
+
+    Initialize();
 }
 
-std::vector<Vec3f> ClothSimulationSystem::getPos()
+ClothSimulationSystem::ClothSimulationSystem(ParticleBuffer&& pos, FloatArray&& invMass,
+                            std::vector<Constraint>&& constraints)
+    : m_currPos(std::move(pos)), m_constraints(std::move(constraints)), m_invMass(std::move(invMass))
 {
-    return m_currPos;
+    Initialize();
 }
 
-std::vector<Constraint> ClothSimulationSystem::getConstraints()
+// Everything derived from the positions, inverse masses and constraints.
+void ClothSimulationSystem::Initialize()
 {
-    return m_constraints;
+    m_oldPos = m_currPos;
+    m_forces.resize(m_currPos.size());
+
+    PackConstraints();
+    ColorConstraints();
+    BuildJacobiAdjacency();
 }
 
-void ClothSimulationSystem::AccumulateForces(float stepSize)
+// Share of the correction each end of a constraint takes, depending on
+// which ends can move.
+static inline void pairWeights(const float* invMass, int idxA, int idxB,
+                               float& weightA, float& weightB)
+{
+    bool movableA = invMass[idxA] > 0.0f;
+    bool movableB = invMass[idxB] > 0.0f;
+
+    weightA = movableA ? (movableB ? 0.5f : 1.0f) : 0.0f;
+    weightB = movableB ? (movableA ? 0.5f : 1.0f) : 0.0f;
+}
+
+static inline void constraintWeights(const float* invMass, const Constraint& c,
+                                     float& weightA, float& weightB)
+{
+    pairWeights(invMass, c.idxA, c.idxB, weightA, weightB);
+}
+
+template<typename Index>
+static void packConstraints(const float* invMass, const Constraint* constraints, int begin, int end,
+                            std::vector<PackedConstraint<Index>>& packed)
+{
+    for(int i = begin; i < end; i++)
+    {
+        const Constraint& c = constraints[i];
+
+        // none of them can move, tough luck
+        if(invMass[c.idxA] <= 0.0f && invMass[c.idxB] <= 0.0f)
+        {
+            continue;
+        }
+
+        PackedConstraint<Index> p;
+        p.idxA = static_cast<Index>(c.idxA);
+        p.idxB = static_cast<Index>(c.idxB);
+        constraintWeights(invMass, c, p.weightA, p.weightB);
+        p.restlength = c.restlength;
+        packed.push_back(p);
+    }
+}
+
+template<typename Index>
+static void packCompliantConstraints(const float* invMass, const std::vector<Constraint>& constraints,
+                                     std::vector<CompliantConstraint<Index>>& packed)
+{
+    for(unsigned int i = 0; i < constraints.size(); i++)
+    {
+        const Constraint& c = constraints[i];
+        if(invMass[c.idxA] <= 0.0f && invMass[c.idxB] <= 0.0f)
+        {
+            continue;
+        }
+
+        CompliantConstraint<Index> p;
+        p.idxA = static_cast<Index>(c.idxA);
+        p.idxB = static_cast<Index>(c.idxB);
+        p.invMassA = invMass[c.idxA];
+        p.invMassB = invMass[c.idxB];
+        p.restlength = c.restlength;
+        p.compliance = c.compliance;
+        packed.push_back(p);
+    }
+}
+
+void ClothSimulationSystem::PackConstraints()
+{
+    m_narrowIndices = m_currPos.size() <= maxNarrowParticles;
+    m_packedConstraints.clear();
+    m_narrowConstraints.clear();
+    m_compliantConstraints.clear();
+    m_narrowCompliant.clear();
+
+    if(m_narrowIndices)
+    {
+        packConstraints(m_invMass.data(), m_constraints.data(), 0, m_constraints.size(), m_narrowConstraints);
+    }
+    else
+    {
+        packConstraints(m_invMass.data(), m_constraints.data(), 0, m_constraints.size(), m_packedConstraints);
+    }
+
+    // the other solvers have no use for these
+    m_lambdas.clear();
+    m_constraintLevels.clear();
+
+    if(m_solver == ConstraintSolver::Xpbd && m_narrowIndices)
+    {
+        packCompliantConstraints(m_invMass.data(), m_constraints, m_narrowCompliant);
+        m_lambdas.assign(m_narrowCompliant.size(), 0.0f);
+    }
+    else if(m_solver == ConstraintSolver::Xpbd)
+    {
+        packCompliantConstraints(m_invMass.data(), m_constraints, m_compliantConstraints);
+        m_lambdas.assign(m_compliantConstraints.size(), 0.0f);
+    }
+    else if(m_solver == ConstraintSolver::Multigrid)
+    {
+        buildConstraintHierarchy(m_invMass, m_constraints, minCoarseParticles, m_constraintLevels);
+    }
+}
+
+// Whether PackConstraints builds anything for solver alone.
+static bool hasSolverData(ConstraintSolver solver)
+{
+    return solver == ConstraintSolver::Xpbd || solver == ConstraintSolver::Multigrid;
+}
+
+void ClothSimulationSystem::ColorConstraints()
+{
+    // Greedy edge coloring: each constraint takes the first color that none
+    // of its two particles is part of yet. Colors are tracked in a 64-bit
+    // mask per particle; the rare constraints that don't fit in 64 colors
+    // (particles with a huge number of constraints) end up in one extra
+    // batch that is solved serially.
+    static const int maxColors = 64;
+
+    std::vector<uint64_t> usedColors(m_currPos.size(), 0);
+    std::vector<int> colors(m_constraints.size());
+    std::vector<int> colorSizes(maxColors + 1, 0);
+
+    m_numParallelColors = 0;
+    for(unsigned int i = 0; i < m_constraints.size(); i++)
+    {
+        const Constraint& c = m_constraints[i];
+        uint64_t used = usedColors[c.idxA] | usedColors[c.idxB];
+        int color = maxColors;
+
+        if(~used != 0)
+        {
+            color = __builtin_ctzll(~used);
+            usedColors[c.idxA] |= uint64_t(1) << color;
+            usedColors[c.idxB] |= uint64_t(1) << color;
+            m_numParallelColors = std::max(m_numParallelColors, color + 1);
+        }
+
+        colors[i] = color;
+        colorSizes[color]++;
+    }
+
+    // counting sort of the constraints by color, keeping their relative order
+    std::vector<int> colorOffsets(maxColors + 2, 0);
+    for(int k = 0; k <= maxColors; k++)
+    {
+        colorOffsets[k + 1] = colorOffsets[k] + colorSizes[k];
+    }
+
+    std::vector<int> fill(colorOffsets.begin(), colorOffsets.end() - 1);
+    std::vector<Constraint> colored(m_constraints.size());
+    for(unsigned int i = 0; i < m_constraints.size(); i++)
+    {
+        colored[fill[colors[i]]++] = m_constraints[i];
+    }
+
+    // then packed color by color, which drops the ones between pinned particles
+    m_colorOffsets.assign(maxColors + 2, 0);
+    m_packedColored.clear();
+    m_narrowColored.clear();
+    for(int k = 0; k <= maxColors; k++)
+    {
+        if(m_narrowIndices)
+        {
+            packConstraints(m_invMass.data(), colored.data(), colorOffsets[k], colorOffsets[k + 1], m_narrowColored);
+            m_colorOffsets[k + 1] = m_narrowColored.size();
+        }
+        else
+        {
+            packConstraints(m_invMass.data(), colored.data(), colorOffsets[k], colorOffsets[k + 1], m_packedColored);
+            m_colorOffsets[k + 1] = m_packedColored.size();
+        }
+    }
+}
+
+void ClothSimulationSystem::BuildJacobiAdjacency()
+{
+    const int numParticles = m_currPos.size();
+    const int numConstraints = m_constraints.size();
+
+    std::vector<int> counts(numParticles, 0);
+    for(int i = 0; i < numConstraints; i++)
+    {
+        counts[m_constraints[i].idxA]++;
+        counts[m_constraints[i].idxB]++;
+    }
+
+    m_jacobiOffsets.assign(numParticles + 1, 0);
+    for(int i = 0; i < numParticles; i++)
+    {
+        m_jacobiOffsets[i + 1] = m_jacobiOffsets[i] + counts[i];
+    }
+
+    // entries of a particle are stored in the order the constraints were
+    // loaded in, so the gather sums in the same order however particles and
+    // constraints were reordered since
+    std::vector<int> loadOrder(numConstraints);
+    for(int i = 0; i < numConstraints; i++)
+    {
+        int original = m_originalConstraintIndex.empty() ? i : m_originalConstraintIndex[i];
+        loadOrder[original] = i;
+    }
+
+    std::vector<int> fill(m_jacobiOffsets.begin(), m_jacobiOffsets.end() - 1);
+    m_jacobiConstraints.resize(2 * numConstraints);
+    m_jacobiWeights.resize(2 * numConstraints);
+    for(int n = 0; n < numConstraints; n++)
+    {
+        const int i = loadOrder[n];
+        const Constraint& c = m_constraints[i];
+        float weightA, weightB;
+        constraintWeights(m_invMass.data(), c, weightA, weightB);
+
+        m_jacobiConstraints[fill[c.idxA]] = i;
+        m_jacobiWeights[fill[c.idxA]++] = weightA;
+        m_jacobiConstraints[fill[c.idxB]] = i;
+        m_jacobiWeights[fill[c.idxB]++] = -weightB;
+    }
+
+    // a particle's weights are either all 0 (pinned) or all non-zero, so
+    // dividing by the count averages over the constraints that move it
+    for(int i = 0; i < numParticles; i++)
+    {
+        for(int k = m_jacobiOffsets[i]; k < m_jacobiOffsets[i + 1]; k++)
+        {
+            m_jacobiWeights[k] /= counts[i];
+        }
+    }
+
+    m_corrections.resize(numConstraints);
+}
+
+static void gather(FloatArray& values, const std::vector<int>& order)
+{
+    FloatArray gathered(order.size());
+    for(unsigned int i = 0; i < order.size(); i++)
+    {
+        gathered[i] = values[order[i]];
+    }
+    values.swap(gathered);
+}
+
+static void gather(ParticleBuffer& buffer, const std::vector<int>& order)
+{
+    gather(buffer.x, order);
+    gather(buffer.y, order);
+    gather(buffer.z, order);
+}
+
+// Moves the particle at index order[i] to index i, in every per-particle
+// buffer and in the constraints.
+void ClothSimulationSystem::PermuteParticles(const std::vector<int>& order)
+{
+    const int numParticles = order.size();
+
+    gather(m_currPos, order);
+    gather(m_oldPos, order);
+    gather(m_forces, order);
+    gather(m_invMass, order);
+
+    std::vector<int> newIndex(numParticles);
+    for(int i = 0; i < numParticles; i++)
+    {
+        newIndex[order[i]] = i;
+    }
+    for(unsigned int c = 0; c < m_constraints.size(); c++)
+    {
+        m_constraints[c].idxA = newIndex[m_constraints[c].idxA];
+        m_constraints[c].idxB = newIndex[m_constraints[c].idxB];
+    }
+
+    std::vector<int> originalIndex(order);
+    if(!m_originalIndex.empty())
+    {
+        for(int i = 0; i < numParticles; i++)
+        {
+            originalIndex[i] = m_originalIndex[order[i]];
+        }
+    }
+    m_originalIndex.swap(originalIndex);
+
+    // found again by the next step, with the new indices
+    m_collisionOffsets.clear();
+    m_collisionPartners.clear();
+}
+
+void ClothSimulationSystem::ReorderParticles(const std::vector<int>& order)
+{
+    const int numConstraints = m_constraints.size();
+
+    if(m_originalIndex.empty())
+    {
+        m_originalConstraintIndex.resize(numConstraints);
+        for(int c = 0; c < numConstraints; c++)
+        {
+            m_originalConstraintIndex[c] = c;
+        }
+    }
+    PermuteParticles(order);
+
+    // by lowest then highest particle, keeping the given order among
+    // duplicates so that the Gauss-Seidel sweep stays deterministic
+    std::vector<int> constraintOrder(numConstraints);
+    for(int c = 0; c < numConstraints; c++)
+    {
+        constraintOrder[c] = c;
+    }
+    std::stable_sort(constraintOrder.begin(), constraintOrder.end(), [&](int a, int b)
+    {
+        const Constraint& ca = m_constraints[a];
+        const Constraint& cb = m_constraints[b];
+        int firstA = std::min(ca.idxA, ca.idxB), firstB = std::min(cb.idxA, cb.idxB);
+        if(firstA != firstB)
+        {
+            return firstA < firstB;
+        }
+        return std::max(ca.idxA, ca.idxB) < std::max(cb.idxA, cb.idxB);
+    });
+
+    std::vector<Constraint> constraints(numConstraints);
+    std::vector<int> originalConstraintIndex(numConstraints);
+    for(int c = 0; c < numConstraints; c++)
+    {
+        constraints[c] = m_constraints[constraintOrder[c]];
+        originalConstraintIndex[c] = m_originalConstraintIndex[constraintOrder[c]];
+    }
+    m_constraints.swap(constraints);
+    m_originalConstraintIndex.swap(originalConstraintIndex);
+
+    PackConstraints();
+    ColorConstraints();
+    BuildJacobiAdjacency();
+}
+
+void ClothSimulationSystem::ReorderParticles(ParticleOrdering ordering)
+{
+    std::vector<int> order;
+
+    if(ordering == ParticleOrdering::Original)
+    {
+        if(m_originalIndex.empty())
+        {
+            return;
+        }
+
+        order.resize(m_originalIndex.size());
+        for(unsigned int i = 0; i < m_originalIndex.size(); i++)
+        {
+            order[m_originalIndex[i]] = i;
+        }
+        PermuteParticles(order);
+
+        std::vector<Constraint> constraints(m_constraints.size());
+        for(unsigned int c = 0; c < m_constraints.size(); c++)
+        {
+            constraints[m_originalConstraintIndex[c]] = m_constraints[c];
+        }
+        m_constraints.swap(constraints);
+        m_originalIndex.clear();
+        m_originalConstraintIndex.clear();
+
+        PackConstraints();
+        ColorConstraints();
+        BuildJacobiAdjacency();
+        return;
+    }
+
+    if(ordering == ParticleOrdering::Morton)
+    {
+        computeMortonOrder(m_currPos, order);
+    }
+    else
+    {
+        computeReverseCuthillMcKeeOrder(m_currPos.size(), m_constraints, order);
+    }
+    ReorderParticles(order);
+}
+
+void ClothSimulationSystem::setConstraintSolver(ConstraintSolver solver)
+{
+    bool repack = solver != m_solver && (hasSolverData(solver) || hasSolverData(m_solver));
+    m_solver = solver;
+    if(repack)
+    {
+        PackConstraints();
+    }
+}
+
+void ClothSimulationSystem::setConstraintCompliance(float compliance)
+{
+    for(unsigned int i = 0; i < m_constraints.size(); i++)
+    {
+        m_constraints[i].compliance = compliance;
+    }
+    if(m_solver == ConstraintSolver::Xpbd)
+    {
+        PackConstraints();
+    }
+}
+
+void ClothSimulationSystem::setRelaxationIterations(int minIterations, int maxIterations, float tolerance)
+{
+    m_minRelaxIter = std::max(0, minIterations);
+    m_maxRelaxIter = std::max(m_minRelaxIter, maxIterations);
+    m_relaxTolerance = tolerance;
+}
+
+void ClothSimulationSystem::setSubsteps(int numSubsteps)
+{
+    m_numSubsteps = std::max(1, numSubsteps);
+}
+
+void ClothSimulationSystem::setSelfCollision(bool enabled, float thickness)
+{
+    m_selfCollision = enabled && thickness > 0.0f;
+    m_collisionThickness = thickness;
+    m_collisionOffsets.clear();
+    m_collisionPartners.clear();
+}
+
+void ClothSimulationSystem::addCollisionMesh(std::shared_ptr<const CollisionMesh> mesh, float thickness)
+{
+    MeshCollider collider;
+    collider.mesh = mesh;
+    collider.thickness = thickness;
+    m_collisionMeshes.push_back(collider);
+}
+
+void ClothSimulationSystem::clearCollisionMeshes()
+{
+    m_collisionMeshes.clear();
+}
+
+void ClothSimulationSystem::setNumThreads(int numThreads)
+{
+    if(numThreads <= 1)
+    {
+        m_threadPool.reset();
+    }
+    else if(!m_threadPool || m_threadPool->getNumThreads() != numThreads)
+    {
+        m_threadPool = std::make_shared<ThreadPool>(numThreads);
+    }
+}
+
+void ClothSimulationSystem::ParallelFor(int count, const std::function<void(int, int)>& task, int grainSize)
+{
+    if(m_threadPool)
+    {
+        m_threadPool->ParallelFor(count, task, grainSize);
+    }
+    else if(count > 0)
+    {
+        task(0, count);
+    }
+}
+
+std::vector<Vec3f> ClothSimulationSystem::getPos() const
+{
+    std::vector<Vec3f> pos;
+    getPos(pos);
+    return pos;
+}
+
+std::vector<Constraint> ClothSimulationSystem::getConstraints() const
+{
+    if(m_originalIndex.empty())
+    {
+        return m_constraints;
+    }
+
+    std::vector<Constraint> constraints(m_constraints.size());
+    for(unsigned int c = 0; c < m_constraints.size(); c++)
+    {
+        Constraint& constraint = constraints[m_originalConstraintIndex[c]];
+        constraint = m_constraints[c];
+        constraint.idxA = m_originalIndex[constraint.idxA];
+        constraint.idxB = m_originalIndex[constraint.idxB];
+    }
+    return constraints;
+}
+
+PositionsView ClothSimulationSystem::getPositionsView() const
+{
+    PositionsView view;
+    view.x = m_currPos.x;
+    view.y = m_currPos.y;
+    view.z = m_currPos.z;
+    return view;
+}
+
+void ClothSimulationSystem::getPos(std::vector<Vec3f>& pos) const
+{
+    pos.resize(m_currPos.size());
+
+    for(unsigned int i = 0; i < pos.size(); i++)
+    {
+        int dst = m_originalIndex.empty() ? i : m_originalIndex[i];
+        pos[dst] = Vec3f(m_currPos.x[i], m_currPos.y[i], m_currPos.z[i]);
+    }
+}
+
+void ClothSimulationSystem::copyPositions(float* xyz) const
 {
     for(unsigned int i = 0; i < m_currPos.size(); i++)
     {
-    	if(m_isMovable[i])
-    	{
-	        m_currPos[i] = m_currPos[i] + m_forces[i] * stepSize;
-	        m_forces[i] = Vec3f(0.0f, 0.0f, 0.0f); // force has been applied
-	    }
+        int dst = m_originalIndex.empty() ? i : m_originalIndex[i];
+        xyz[3 * dst + 0] = m_currPos.x[i];
+        xyz[3 * dst + 1] = m_currPos.y[i];
+        xyz[3 * dst + 2] = m_currPos.z[i];
     }
 }
 
-void ClothSimulationSystem::Verlet(float stepSize) 
+void ClothSimulationSystem::copyPositions(float* x, float* y, float* z) const
 {
     for(unsigned int i = 0; i < m_currPos.size(); i++)
     {
-    	if(m_isMovable[i])
-    	{
-    		Vec3f newPos = (m_currPos[i] + m_currPos[i]) - m_oldPos[i] +
-	            m_forces[i] * (stepSize * stepSize / particleMass);
+        int dst = m_originalIndex.empty() ? i : m_originalIndex[i];
+        x[dst] = m_currPos.x[i];
+        y[dst] = m_currPos.y[i];
+        z[dst] = m_currPos.z[i];
+    }
+}
+
+void ClothSimulationSystem::AccumulateForces(float stepSize)
+{
+    CLOTH_PROFILE_SCOPE("accumulate_forces");
+    const IntegratorKernels& kernels = getIntegratorKernels();
+
+    ParallelFor(m_currPos.size(), [&](int begin, int end)
+    {
+        kernels.accumulateForces(m_currPos, m_forces, m_invMass.data(), stepSize, begin, end);
+    }, parallelGrainSize);
+}
+
+void ClothSimulationSystem::Verlet(float stepSize) 
+{
+    CLOTH_PROFILE_SCOPE("verlet");
+    const IntegratorKernels& kernels = getIntegratorKernels();
+
+    ParallelFor(m_currPos.size(), [&](int begin, int end)
+    {
+        kernels.verlet(m_currPos, m_oldPos, m_forces, m_invMass.data(), stepSize, begin, end);
+    }, parallelGrainSize);
+}
+
+// Violation of a constraint of the given length, relative to that length.
+// Particles on top of each other (e.g. both clamped to the ground) give no
+// direction to push them apart in, so such a constraint is left alone.
+static inline float relativeViolation(float deltaLength, float restLength)
+{
+    return deltaLength > 0.0f ? (deltaLength - restLength) / deltaLength : 0.0f;
+}
+
+// Projects c and returns its violation before the projection.
+template<typename Index>
+static inline float projectConstraint(float* px, float* py, float* pz, const PackedConstraint<Index>& c)
+{
+    float dx = px[c.idxB] - px[c.idxA];
+    float dy = py[c.idxB] - py[c.idxA];
+    float dz = pz[c.idxB] - pz[c.idxA];
+
+    float deltaLength = sqrt(dx * dx + dy * dy + dz * dz);
+    float diff = relativeViolation(deltaLength, c.restlength);
+    float diffA = c.weightA * diff;
+    float diffB = c.weightB * diff;
+
+    px[c.idxA] += dx * diffA; py[c.idxA] += dy * diffA; pz[c.idxA] += dz * diffA;
+    px[c.idxB] -= dx * diffB; py[c.idxB] -= dy * diffB; pz[c.idxB] -= dz * diffB;
+    return diff;
+}
+
+// Projects constraints [begin, end) in order; when measure is set, also
+// gathers their violations.
+template<bool measure, typename Index>
+static void projectConstraints(float* px, float* py, float* pz, const PackedConstraint<Index>* constraints,
+                               int begin, int end, float& maxDiff, double& sumSquares)
+{
+    for(int j = begin; j < end; j++)
+    {
+        float diff = projectConstraint(px, py, pz, constraints[j]);
+        if(measure)
+        {
+            maxDiff = std::max(maxDiff, std::abs(diff));
+            sumSquares += diff * diff;
+        }
+    }
+}
+
+template<typename Index>
+void ClothSimulationSystem::SolveConstraintsGaussSeidel(const std::vector<PackedConstraint<Index>>& constraints,
+                                                        const std::vector<PackedConstraint<Index>>& colored,
+                                                        Violation* violation)
+{
+    CLOTH_PROFILE_SCOPE("solve_constraints");
+    float* px = m_currPos.x.data();
+    float* py = m_currPos.y.data();
+    float* pz = m_currPos.z.data();
+
+    auto project = [&](const PackedConstraint<Index>* batch, int begin, int end, float& maxDiff, double& sumSquares)
+    {
+        if(violation)
+        {
+            projectConstraints<true>(px, py, pz, batch, begin, end, maxDiff, sumSquares);
+        }
+        else
+        {
+            projectConstraints<false>(px, py, pz, batch, begin, end, maxDiff, sumSquares);
+        }
+    };
+
+    float maxDiff = 0.0f;
+    double sumSquares = 0.0;
+
+    if(m_solver == ConstraintSolver::ColoredGaussSeidel)
+    {
+        std::mutex mutex;
+        for(int k = 0; k < m_numParallelColors; k++)
+        {
+            const PackedConstraint<Index>* batch = &colored[m_colorOffsets[k]];
+            ParallelFor(m_colorOffsets[k + 1] - m_colorOffsets[k], [&](int begin, int end)
+            {
+                float chunkMax = 0.0f;
+                double chunkSum = 0.0;
+                project(batch, begin, end, chunkMax, chunkSum);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                maxDiff = std::max(maxDiff, chunkMax);
+                sumSquares += chunkSum;
+            }, parallelGrainSize);
+        }
+
+        project(colored.data(), m_colorOffsets[m_numParallelColors], m_colorOffsets.back(), maxDiff, sumSquares);
+    }
+    else
+    {
+        project(constraints.data(), 0, constraints.size(), maxDiff, sumSquares);
+    }
+
+    if(violation)
+    {
+        violation->max = maxDiff;
+        violation->sumSquares = sumSquares;
+    }
+}
+
+// XPBD update of c with the compliance scaled by 1 / dt^2 (alphaScale):
+// dlambda = (-C - alpha * lambda) / (wA + wB + alpha), then each end moves
+// along the constraint by its inverse mass times dlambda. Returns the
+// residual C + alpha * lambda before the update, relative to the length.
+template<typename Index>
+static inline float projectCompliantConstraint(float* px, float* py, float* pz,
+                                               const CompliantConstraint<Index>& c,
+                                               float alphaScale, float& lambda)
+{
+    float dx = px[c.idxB] - px[c.idxA];
+    float dy = py[c.idxB] - py[c.idxA];
+    float dz = pz[c.idxB] - pz[c.idxA];
+
+    // particles on top of each other (e.g. both clamped to the ground) give
+    // no direction to push them apart in, so lambda doesn't build up either
+    float deltaLength = sqrt(dx * dx + dy * dy + dz * dz);
+    if(deltaLength <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    float alpha = c.compliance * alphaScale;
+    float residual = deltaLength - c.restlength + alpha * lambda;
+    float deltaLambda = -residual / (c.invMassA + c.invMassB + alpha);
+    lambda += deltaLambda;
+
+    float scale = deltaLambda / deltaLength;
+    float diffA = c.invMassA * scale;
+    float diffB = c.invMassB * scale;
+
+    px[c.idxA] -= dx * diffA; py[c.idxA] -= dy * diffA; pz[c.idxA] -= dz * diffA;
+    px[c.idxB] += dx * diffB; py[c.idxB] += dy * diffB; pz[c.idxB] += dz * diffB;
+    return residual / deltaLength;
+}
+
+template<typename Index>
+void ClothSimulationSystem::SolveConstraintsXpbd(const std::vector<CompliantConstraint<Index>>& constraints,
+                                                 float stepSize, Violation* violation)
+{
+    CLOTH_PROFILE_SCOPE("solve_constraints");
+    float* px = m_currPos.x.data();
+    float* py = m_currPos.y.data();
+    float* pz = m_currPos.z.data();
+    float* lambdas = m_lambdas.data();
+
+    const float alphaScale = stepSize > 0.0f ? 1.0f / (stepSize * stepSize) : 0.0f;
+    const int numConstraints = constraints.size();
+
+    if(!violation)
+    {
+        for(int j = 0; j < numConstraints; j++)
+        {
+            projectCompliantConstraint(px, py, pz, constraints[j], alphaScale, lambdas[j]);
+        }
+        return;
+    }
+
+    float maxDiff = 0.0f;
+    double sumSquares = 0.0;
+    for(int j = 0; j < numConstraints; j++)
+    {
+        float diff = projectCompliantConstraint(px, py, pz, constraints[j], alphaScale, lambdas[j]);
+        maxDiff = std::max(maxDiff, std::abs(diff));
+        sumSquares += diff * diff;
+    }
+    violation->max = maxDiff;
+    violation->sumSquares = sumSquares;
+}
+
+// Stretch limit of a coarse level, pulling its ends together when they
+// are further apart than the chain of constraints between them allows.
+static inline void projectCoarseConstraint(float* px, float* py, float* pz, const CoarseConstraint& c)
+{
+    float dx = px[c.idxB] - px[c.idxA];
+    float dy = py[c.idxB] - py[c.idxA];
+    float dz = pz[c.idxB] - pz[c.idxA];
+
+    float deltaLength = sqrt(dx * dx + dy * dy + dz * dz);
+    if(deltaLength <= c.maxLength)
+    {
+        return;
+    }
+
+    float diff = (deltaLength - c.maxLength) / deltaLength;
+    float diffA = c.weightA * diff;
+    float diffB = c.weightB * diff;
+
+    px[c.idxA] += dx * diffA; py[c.idxA] += dy * diffA; pz[c.idxA] += dz * diffA;
+    px[c.idxB] -= dx * diffB; py[c.idxB] -= dy * diffB; pz[c.idxB] -= dz * diffB;
+}
+
+// One coarse-to-fine cycle over the coarse levels: the coarsest level is
+// relaxed first, then each finer level starts from its parents' motion
+// (interpolated onto its own particles) and is relaxed in turn, so that a
+// correction crosses the cloth in a few passes instead of one constraint
+// per pass. Restriction is free: coarse particles are particles of the
+// cloth. The finest level, the cloth itself, is left to the caller.
+void ClothSimulationSystem::SolveCoarseLevels()
+{
+    CLOTH_PROFILE_SCOPE("solve_coarse_levels");
+    float* px = m_currPos.x.data();
+    float* py = m_currPos.y.data();
+    float* pz = m_currPos.z.data();
+    const int numLevels = m_constraintLevels.size();
+
+    for(int l = 0; l < numLevels; l++)
+    {
+        ConstraintLevel& level = m_constraintLevels[l];
+        for(unsigned int k = 0; k < level.particles.size(); k++)
+        {
+            level.motion.x[k] = px[level.particles[k]];
+            level.motion.y[k] = py[level.particles[k]];
+            level.motion.z[k] = pz[level.particles[k]];
+        }
+    }
+
+    for(int l = numLevels - 1; l >= 0; l--)
+    {
+        ConstraintLevel& level = m_constraintLevels[l];
+        const int numConstraints = level.constraints.size();
+        for(int sweep = 0; sweep < coarseSweeps; sweep++)
+        {
+            for(int j = 0; j < numConstraints; j++)
+            {
+                projectCoarseConstraint(px, py, pz, level.constraints[j]);
+            }
+        }
+
+        // prolongation onto the rest of the finer level
+        float* mx = level.motion.x.data();
+        float* my = level.motion.y.data();
+        float* mz = level.motion.z.data();
+        for(unsigned int k = 0; k < level.particles.size(); k++)
+        {
+            mx[k] = px[level.particles[k]] - mx[k];
+            my[k] = py[level.particles[k]] - my[k];
+            mz[k] = pz[level.particles[k]] - mz[k];
+        }
+
+        for(unsigned int f = 0; f < level.fineParticles.size(); f++)
+        {
+            float sumX = 0.0f, sumY = 0.0f, sumZ = 0.0f;
+            for(int j = level.parentOffsets[f]; j < level.parentOffsets[f + 1]; j++)
+            {
+                float weight = level.parentWeights[j];
+                sumX += mx[level.parents[j]] * weight;
+                sumY += my[level.parents[j]] * weight;
+                sumZ += mz[level.parents[j]] * weight;
+            }
+
+            int i = level.fineParticles[f];
+            px[i] += sumX;
+            py[i] += sumY;
+            pz[i] += sumZ;
+        }
+    }
+}
+
+void ClothSimulationSystem::SolveConstraintsJacobi(Violation* violation)
+{
+    CLOTH_PROFILE_SCOPE("solve_constraints");
+    const float* px = m_currPos.x.data();
+    const float* py = m_currPos.y.data();
+    const float* pz = m_currPos.z.data();
+    const float* invMass = m_invMass.data();
+    float* cx = m_corrections.x.data();
+    float* cy = m_corrections.y.data();
+    float* cz = m_corrections.z.data();
+    std::mutex mutex;
+
+    // every constraint computes its full correction from the current
+    // positions, without touching them
+    ParallelFor(m_constraints.size(), [&](int begin, int end)
+    {
+        float maxDiff = 0.0f;
+        double sumSquares = 0.0;
+
+        for(int i = begin; i < end; i++)
+        {
+            const Constraint& c = m_constraints[i];
+            float dx = px[c.idxB] - px[c.idxA];
+            float dy = py[c.idxB] - py[c.idxA];
+            float dz = pz[c.idxB] - pz[c.idxA];
+
+            float deltaLength = sqrt(dx * dx + dy * dy + dz * dz);
+            float diff = relativeViolation(deltaLength, c.restlength);
+
+            cx[i] = dx * diff;
+            cy[i] = dy * diff;
+            cz[i] = dz * diff;
+
+            // constraints between pinned particles can't be relaxed
+            if(violation && invMass[c.idxA] + invMass[c.idxB] > 0.0f)
+            {
+                maxDiff = std::max(maxDiff, std::abs(diff));
+                sumSquares += diff * diff;
+            }
+        }
+
+        if(violation)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            violation->max = std::max(violation->max, maxDiff);
+            violation->sumSquares += sumSquares;
+        }
+    }, parallelGrainSize);
+
+    // then each particle gathers the weighted average of its corrections
+    float* qx = m_currPos.x.data();
+    float* qy = m_currPos.y.data();
+    float* qz = m_currPos.z.data();
+
+    ParallelFor(m_currPos.size(), [&](int begin, int end)
+    {
+        for(int i = begin; i < end; i++)
+        {
+            float sumX = 0.0f, sumY = 0.0f, sumZ = 0.0f;
+
+            for(int k = m_jacobiOffsets[i]; k < m_jacobiOffsets[i + 1]; k++)
+            {
+                int c = m_jacobiConstraints[k];
+                float w = m_jacobiWeights[k];
+                sumX += cx[c] * w;
+                sumY += cy[c] * w;
+                sumZ += cz[c] * w;
+            }
+
+            qx[i] += sumX;
+            qy[i] += sumY;
+            qz[i] += sumZ;
+        }
+    }, parallelGrainSize);
+}
+
+// Calls visit(j) for every particle j > i closer than radius to particle i
+// that can move or lets i move, in an order that only depends on the grid.
+template <typename Visitor>
+static inline void forEachCollisionCandidate(const SpatialHashGrid& grid, const ParticleBuffer& pos,
+                                             const float* invMass, int i, float radius,
+                                             Visitor&& visit)
+{
+    const float x = pos.x[i], y = pos.y[i], z = pos.z[i];
+    const float radiusSq = radius * radius;
+    const int* sorted = grid.getSortedParticles().data();
+    const ParticleBuffer& sortedPos = grid.getSortedPositions();
+
+    grid.ForEachNeighbor(x, y, z, [&](int k)
+    {
+        float dx = sortedPos.x[k] - x;
+        float dy = sortedPos.y[k] - y;
+        float dz = sortedPos.z[k] - z;
+        int j = sorted[k];
+
+        if(dx * dx + dy * dy + dz * dz < radiusSq && j > i && invMass[i] + invMass[j] > 0.0f)
+        {
+            visit(j);
+        }
+    });
+}
+
+// Distance each particle moved in the last Verlet step, into
+// m_particleMotion; returns the largest.
+float ClothSimulationSystem::ComputeParticleMotion()
+{
+    const int numParticles = m_currPos.size();
+    float maxMotion = 0.0f;
+
+    m_particleMotion.resize(numParticles);
+    for(int i = 0; i < numParticles; i++)
+    {
+        float dx = m_currPos.x[i] - m_oldPos.x[i];
+        float dy = m_currPos.y[i] - m_oldPos.y[i];
+        float dz = m_currPos.z[i] - m_oldPos.z[i];
+        m_particleMotion[i] = sqrt(dx * dx + dy * dy + dz * dz);
+        maxMotion = std::max(maxMotion, m_particleMotion[i]);
+    }
+    return maxMotion;
+}
+
+void ClothSimulationSystem::FindSelfCollisions(int numSubsteps)
+{
+    CLOTH_PROFILE_SCOPE("find_self_collisions");
+    const int numParticles = m_currPos.size();
+    const int numBlocks = (numParticles + collisionBlockSize - 1) / collisionBlockSize;
+    const float* invMass = m_invMass.data();
+
+    // pairs found in the first substep are kept for the others, in each of
+    // which two particles can get closer by as much as they both moved in
+    // the first one: the grid is searched with the largest motion, then
+    // pairs are kept within the bound of their own two particles
+    const float contactRadius = m_collisionThickness * (1.0f + collisionMargin);
+    const float remainingSubsteps = numSubsteps - 1;
+    float radius = contactRadius;
+    if(numSubsteps > 1)
+    {
+        radius += 2.0f * remainingSubsteps * ComputeParticleMotion();
+    }
+    const float* motion = m_particleMotion.data();
+
+    m_collisionGrid.Build(m_currPos, radius);
+    m_collisionOffsets.resize(numParticles + 1);
+    m_collisionOffsets[0] = 0;
+    m_collisionBlocks.resize(numBlocks);
+
+    // each block lists the partners of its particles in order, and stores
+    // how many each particle has
+    ParallelFor(numBlocks, [&](int beginBlock, int endBlock)
+    {
+        for(int b = beginBlock; b < endBlock; b++)
+        {
+            std::vector<int>& partners = m_collisionBlocks[b];
+            partners.clear();
+
+            int end = std::min(numParticles, (b + 1) * collisionBlockSize);
+            for(int i = b * collisionBlockSize; i < end; i++)
+            {
+                int count = partners.size();
+                if(numSubsteps == 1)
+                {
+                    forEachCollisionCandidate(m_collisionGrid, m_currPos, invMass, i, radius,
+                                              [&](int j) { partners.push_back(j); });
+                }
+                else
+                {
+                    forEachCollisionCandidate(m_collisionGrid, m_currPos, invMass, i, radius, [&](int j)
+                    {
+                        float dx = m_currPos.x[j] - m_currPos.x[i];
+                        float dy = m_currPos.y[j] - m_currPos.y[i];
+                        float dz = m_currPos.z[j] - m_currPos.z[i];
+                        float reach = contactRadius + remainingSubsteps * (motion[i] + motion[j]);
+                        if(dx * dx + dy * dy + dz * dz < reach * reach)
+                        {
+                            partners.push_back(j);
+                        }
+                    });
+                }
+                m_collisionOffsets[i + 1] = partners.size() - count;
+            }
+        }
+    });
+
+    for(int i = 0; i < numParticles; i++)
+    {
+        m_collisionOffsets[i + 1] += m_collisionOffsets[i];
+    }
+    m_collisionPartners.resize(m_collisionOffsets[numParticles]);
+
+    // then the blocks are laid out one after the other
+    ParallelFor(numBlocks, [&](int beginBlock, int endBlock)
+    {
+        for(int b = beginBlock; b < endBlock; b++)
+        {
+            std::copy(m_collisionBlocks[b].begin(), m_collisionBlocks[b].end(),
+                      m_collisionPartners.begin() + m_collisionOffsets[b * collisionBlockSize]);
+        }
+    });
+}
+
+void ClothSimulationSystem::SolveSelfCollisions()
+{
+    CLOTH_PROFILE_SCOPE("solve_self_collisions");
+    float* px = m_currPos.x.data();
+    float* py = m_currPos.y.data();
+    float* pz = m_currPos.z.data();
+    const float* invMass = m_invMass.data();
+    const float thickness = m_collisionThickness;
+    const int numParticles = m_currPos.size();
 
-	        m_oldPos[i] = m_currPos[i];
-	        m_currPos[i] = newPos;
-    	}
+    // one-sided distance constraints, only pushing particles apart
+    for(int i = 0; i < numParticles; i++)
+    {
+        for(int k = m_collisionOffsets[i]; k < m_collisionOffsets[i + 1]; k++)
+        {
+            int j = m_collisionPartners[k];
+            float dx = px[j] - px[i];
+            float dy = py[j] - py[i];
+            float dz = pz[j] - pz[i];
+            float distanceSq = dx * dx + dy * dy + dz * dz;
+
+            if(distanceSq >= thickness * thickness || distanceSq <= 0.0f)
+            {
+                continue;
+            }
+
+            float distance = sqrt(distanceSq);
+            float diff = (distance - thickness) / distance;
+            float weightI, weightJ;
+            pairWeights(invMass, i, j, weightI, weightJ);
+
+            px[i] += dx * (weightI * diff); py[i] += dy * (weightI * diff); pz[i] += dz * (weightI * diff);
+            px[j] -= dx * (weightJ * diff); py[j] -= dy * (weightJ * diff); pz[j] -= dz * (weightJ * diff);
+        }
     }
 }
 
-void ClothSimulationSystem::SatisfyConstraints()
+void ClothSimulationSystem::FindMeshContacts(int numSubsteps)
+{
+    CLOTH_PROFILE_SCOPE("find_mesh_contacts");
+    const int numParticles = m_currPos.size();
+    const float* invMass = m_invMass.data();
+
+    m_contactNormals.resize(numParticles);
+    m_contactOffsets.resize(numParticles);
+
+    ParallelFor(numParticles, [&](int begin, int end)
+    {
+        for(int i = begin; i < end; i++)
+        {
+            Vec3f p = Vec3f(m_currPos.x[i], m_currPos.y[i], m_currPos.z[i]);
+            Vec3f motion = p - Vec3f(m_oldPos.x[i], m_oldPos.y[i], m_oldPos.z[i]);
+            Vec3f normal;
+            float offset = 0.0f;
+            float closest = INFINITY;
+
+            for(unsigned int m = 0; m < m_collisionMeshes.size() && invMass[i] > 0.0f; m++)
+            {
+                const MeshCollider& collider = m_collisionMeshes[m];
+                Vec3f point, direction;
+
+                // a particle that went through the surface during the step
+                // is at most as far behind it as it moved, and the contact
+                // also has to catch it in the substeps still to come
+                float radius = collider.thickness * (1.0f + collisionMargin) +
+                               sqrt(motion.dot(motion)) * numSubsteps;
+
+                if(collider.mesh->FindContact(p, radius, point, direction))
+                {
+                    Vec3f delta = p - point;
+                    float distance = delta.dot(delta);
+                    if(distance < closest)
+                    {
+                        closest = distance;
+                        normal = direction;
+                        offset = direction.dot(point) + collider.thickness;
+                    }
+                }
+            }
+
+            m_contactNormals.x[i] = normal[0];
+            m_contactNormals.y[i] = normal[1];
+            m_contactNormals.z[i] = normal[2];
+            m_contactOffsets[i] = offset;
+        }
+    });
+}
+
+void ClothSimulationSystem::SolveMeshContacts()
+{
+    CLOTH_PROFILE_SCOPE("solve_mesh_contacts");
+    float* px = m_currPos.x.data();
+    float* py = m_currPos.y.data();
+    float* pz = m_currPos.z.data();
+    const float* nx = m_contactNormals.x.data();
+    const float* ny = m_contactNormals.y.data();
+    const float* nz = m_contactNormals.z.data();
+    const float* offsets = m_contactOffsets.data();
+
+    // no branches: particles without contact have a zero normal and offset,
+    // so their penetration is always 0
+    ParallelFor(m_currPos.size(), [&](int begin, int end)
+    {
+        for(int i = begin; i < end; i++)
+        {
+            float penetration = std::min(nx[i] * px[i] + ny[i] * py[i] + nz[i] * pz[i] - offsets[i], 0.0f);
+            px[i] -= nx[i] * penetration;
+            py[i] -= ny[i] * penetration;
+            pz[i] -= nz[i] * penetration;
+        }
+    }, parallelGrainSize);
+}
+
+void ClothSimulationSystem::SolveColliders()
 {
-    for(unsigned int i = 0; i < numRelaxIter; i++)
+    CLOTH_PROFILE_SCOPE("solve_colliders");
+    const IntegratorKernels& kernels = getIntegratorKernels();
+
+    ParallelFor(m_currPos.size(), [&](int begin, int end)
+    {
+        kernels.projectColliders(m_currPos, m_invMass.data(), m_colliders, begin, end);
+    }, parallelGrainSize);
+}
+
+static double elapsedNs(std::chrono::steady_clock::time_point& since)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(now - since).count();
+    since = now;
+    return ns;
+}
+
+void ClothSimulationSystem::SatisfyConstraints(float stepSize)
+{
+    CLOTH_PROFILE_SCOPE("satisfy_constraints");
+    float* py = m_currPos.y.data();
+
+    const int numMeasured = m_narrowIndices ? m_narrowConstraints.size() : m_packedConstraints.size();
+    m_lastSolverStats = SolverStats();
+
+    // multipliers only accumulate within a step
+    std::fill(m_lambdas.begin(), m_lambdas.end(), 0.0f);
+
+    for(int i = 0; i < m_maxRelaxIter; i++)
     {
+        CLOTH_PROFILE_SCOPE("relaxation_pass");
+
+        // violations are only measured by the passes that may end the loop
+        Violation violation;
+        bool measure = i + 1 >= m_minRelaxIter && i + 1 < m_maxRelaxIter && m_relaxTolerance > 0.0f;
+
+        if(m_solver == ConstraintSolver::Multigrid)
+        {
+            SolveCoarseLevels();
+        }
+
         // makes sure constraints specified during creation are respected
-        for(std::vector<Constraint>::iterator it = m_constraints.begin();
-            it != m_constraints.end(); ++it) 
-        {
-            Constraint c = *it;
-            Vec3f pA = m_currPos[c.idxA];
-            Vec3f pB = m_currPos[c.idxB];
-
-            Vec3f delta = pB - pA;
-            float deltaLength = sqrt(delta.dot(delta));
-            float diff = (deltaLength - c.restlength) / deltaLength;
-
-            if(m_isMovable[c.idxA] && m_isMovable[c.idxB])
-    		{
-	            m_currPos[c.idxA] = pA + (delta * (0.5f * diff));
-	            m_currPos[c.idxB] = pB - (delta * (0.5f * diff));
-	        }
-	        else if(m_isMovable[c.idxA] && !m_isMovable[c.idxB])
-	        {
-	        	m_currPos[c.idxA] = pA + (delta * diff);
-	        }
-	        else if(!m_isMovable[c.idxA] && m_isMovable[c.idxB])
-	        {
-	        	m_currPos[c.idxB] = pB - (delta * diff);
-	        }
-	        // else: none of them can move, tough luck
+        if(m_solver == ConstraintSolver::Jacobi)
+        {
+            SolveConstraintsJacobi(measure ? &violation : nullptr);
+        }
+        else if(m_solver == ConstraintSolver::Xpbd && m_narrowIndices)
+        {
+            SolveConstraintsXpbd(m_narrowCompliant, stepSize, measure ? &violation : nullptr);
+        }
+        else if(m_solver == ConstraintSolver::Xpbd)
+        {
+            SolveConstraintsXpbd(m_compliantConstraints, stepSize, measure ? &violation : nullptr);
+        }
+        else if(m_narrowIndices)
+        {
+            SolveConstraintsGaussSeidel(m_narrowConstraints, m_narrowColored, measure ? &violation : nullptr);
+        }
+        else
+        {
+            SolveConstraintsGaussSeidel(m_packedConstraints, m_packedColored, measure ? &violation : nullptr);
+        }
+
+        m_lastSolverStats.iterations = i + 1;
+        if(measure)
+        {
+            m_lastSolverStats.maxViolation = violation.max;
+            m_lastSolverStats.rmsViolation = numMeasured > 0 ? sqrt(violation.sumSquares / numMeasured) : 0.0f;
+        }
+
+        if(m_selfCollision)
+        {
+            SolveSelfCollisions();
+        }
+
+        if(!m_collisionMeshes.empty())
+        {
+            SolveMeshContacts();
+        }
+
+        if(!m_colliders.empty())
+        {
+            std::chrono::steady_clock::time_point clock = std::chrono::steady_clock::now();
+            SolveColliders();
+            m_lastStepTimings.collidersNs += elapsedNs(clock);
         }
 
         // makes sure y coordinate can't be negative
-        for(unsigned int i = 0; i < m_currPos.size(); i++)
+        ParallelFor(m_currPos.size(), [&](int begin, int end)
         {
-            m_currPos[i][1] = std::max(0.0f, m_currPos[i][1]);
+            for(int j = begin; j < end; j++)
+            {
+                py[j] = std::max(0.0f, py[j]);
+            }
+        }, parallelGrainSize);
+
+        // a NaN (particles on top of each other) only shows in the sum
+        if(measure && violation.max < m_relaxTolerance && !std::isnan(violation.sumSquares))
+        {
+            break;
         }
     }
 }
 
 void ClothSimulationSystem::ApplyForce(Vec3f forceDirection)
 {
-    for(unsigned int i = 0; i < m_forces.size(); i++)
+    const int numParticles = m_forces.size();
+    float* __restrict fx = m_forces.x.data();
+    float* __restrict fy = m_forces.y.data();
+    float* __restrict fz = m_forces.z.data();
+
+    ParallelFor(numParticles, [&](int begin, int end)
     {
-        m_forces[i] = m_forces[i] + forceDirection;
-    }
+        for(int i = begin; i < end; i++)
+        {
+            fx[i] += forceDirection[0];
+            fy[i] += forceDirection[1];
+            fz[i] += forceDirection[2];
+        }
+    }, parallelGrainSize);
 }
 
 void ClothSimulationSystem::TimeStep(float stepSize) 
 {
-    AccumulateForces(stepSize);
-    Verlet(stepSize);
-    SatisfyConstraints();
+    CLOTH_PROFILE_SCOPE("time_step");
+    std::chrono::steady_clock::time_point clock = std::chrono::steady_clock::now();
+    const float substepSize = stepSize / m_numSubsteps;
+    int iterations = 0;
+
+    m_lastStepTimings = StepTimings();
+
+    // forces displace particles by force * substepSize once, which changes
+    // their velocity as much as force * stepSize does over a single step
+    AccumulateForces(substepSize);
+    m_lastStepTimings.accumulateForcesNs = elapsedNs(clock);
+
+    for(int s = 0; s < m_numSubsteps; s++)
+    {
+        CLOTH_PROFILE_SCOPE("substep");
+
+        Verlet(substepSize);
+        m_lastStepTimings.verletNs += elapsedNs(clock);
+
+        if(s == 0)
+        {
+            if(m_selfCollision)
+            {
+                FindSelfCollisions(m_numSubsteps);
+            }
+            if(!m_collisionMeshes.empty())
+            {
+                FindMeshContacts(m_numSubsteps);
+            }
+            m_lastStepTimings.collisionDetectionNs = elapsedNs(clock);
+        }
+
+        SatisfyConstraints(substepSize);
+        m_lastStepTimings.satisfyConstraintsNs += elapsedNs(clock);
+        iterations += m_lastSolverStats.iterations;
+    }
+
+    m_lastSolverStats.iterations = iterations;
 } 
\ No newline at end of file
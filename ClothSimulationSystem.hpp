@@ -7,15 +7,97 @@
 
 #pragma once
 
+#include <stdint.h>
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "ArrayView.hpp"
+#include "Colliders.hpp"
+#include "CollisionMesh.hpp"
+#include "ConstraintHierarchy.hpp"
+#include "ParticleBuffer.hpp"
+#include "ParticleOrdering.hpp"
+#include "SpatialHashGrid.hpp"
+#include "ThreadPool.hpp"
 #include "Vec3.hpp"
 
 struct Constraint {
     int idxA, idxB;
     float restlength;
+    // inverse stiffness, in length / force units; only the XPBD solver
+    // reads it, 0 is rigid
+    float compliance = 0.0f;
 };
 
+// Constraint as the Gauss-Seidel solvers read it: the share of the
+// correction each end takes is worked out once from the inverse masses
+// (0 for a pinned end), so projecting it needs neither the inverse masses
+// nor a branch. Index is uint16_t for cloths of at most 65536 particles,
+// which brings a constraint down to 16 bytes.
+template<typename Index>
+struct PackedConstraint {
+    Index idxA, idxB;
+    float weightA, weightB;
+    float restlength;
+};
+
+// Constraint as the XPBD solver reads it: the inverse masses of both ends
+// (0 for a pinned end) and the compliance, which together with the step
+// size and the constraint's Lagrange multiplier decide the correction.
+template<typename Index>
+struct CompliantConstraint {
+    Index idxA, idxB;
+    float invMassA, invMassB;
+    float restlength;
+    float compliance;
+};
+
+// Wall-clock time spent in each phase of a TimeStep call, in nanoseconds.
+struct StepTimings {
+    double accumulateForcesNs = 0.0;
+    double verletNs = 0.0;
+    double collisionDetectionNs = 0.0;
+    double satisfyConstraintsNs = 0.0;
+    double collidersNs = 0.0; // part of satisfyConstraintsNs
+};
+
+// What the relaxation of the last TimeStep did: iterations counts the
+// passes of all its substeps, the violations are those of the last one.
+// Violations are
+// |length - rest length| / length of the constraints with a movable end,
+// as the last measured pass found them before projecting them; for XPBD,
+// the residual |length - rest length + compliance * lambda / dt^2| / length,
+// which goes to 0 for soft constraints too. Passes are only measured when
+// a tolerance is set, and the last one never is, since nothing is left to
+// decide after it.
+struct SolverStats {
+    int iterations = 0;
+    float maxViolation = 0.0f;
+    float rmsViolation = 0.0f;
+};
+
+// Current particle positions, straight from the simulation buffers.
+struct PositionsView {
+    ArrayView<float> x, y, z;
+};
+
+enum class ConstraintSolver {
+    GaussSeidel,        // serial in-place sweep, in the order constraints were given
+    ColoredGaussSeidel, // in-place sweep, one parallel batch per constraint color
+    Jacobi,             // corrections computed from the previous iterate, then averaged
+    Xpbd,               // serial sweep like GaussSeidel, with each constraint's
+                        // compliance and Lagrange multiplier (extended PBD)
+    Multigrid           // coarse levels of the cloth first, from the coarsest,
+                        // then the GaussSeidel sweep (hierarchical PBD)
+};
+
+// Command-line names of the solvers ("gauss-seidel", "colored", "jacobi",
+// "xpbd", "multigrid"). parseConstraintSolver returns false for an unknown
+// name.
+bool parseConstraintSolver(const std::string& name, ConstraintSolver& solver);
+const char* getConstraintSolverName(ConstraintSolver solver);
+
 
 class ClothSimulationSystem 
 {
@@ -27,19 +109,220 @@ public:
     ClothSimulationSystem(std::vector<Vec3f>& pos,
                             std::vector<Constraint>& constraints,
                             std::vector<bool>& isMovable);
-    std::vector<Vec3f> getPos();
-    std::vector<Constraint> getConstraints();
+
+    // Takes over particle data that is already laid out as structure of
+    // arrays, without copying it. invMass is 0 for particles that can't move.
+    ClothSimulationSystem(ParticleBuffer&& pos, FloatArray&& invMass,
+                            std::vector<Constraint>&& constraints);
+
+    // Renumbers the particles for cache locality, and sorts the constraints
+    // by their first particle so that the solver walks memory mostly
+    // forward. Meant to be called once after loading: getPos(),
+    // copyPositions() and getConstraints() keep using the caller's original
+    // numbering and order, only the views below expose the new one.
+    // The Jacobi solver gives exactly the same results in any layout; the
+    // Gauss-Seidel sweeps follow the new constraint order, so they only
+    // match within floating-point tolerance.
+    // ParticleOrdering::Original goes back to the original layout.
+    void ReorderParticles(ParticleOrdering ordering);
+    // order[i] is the current index of the particle that becomes i-th.
+    void ReorderParticles(const std::vector<int>& order);
+
+    std::vector<Vec3f> getPos() const;
+    std::vector<Constraint> getConstraints() const;
+
+    // Allocation-free access: views over the internal buffers, valid until
+    // the system is reassigned or destroyed. They follow the internal
+    // numbering, which differs from the original one after ReorderParticles.
+    PositionsView getPositionsView() const;
+    ArrayView<Constraint> getConstraintsView() const { return m_constraints; }
+    ArrayView<float> getInvMassView() const { return m_invMass; }
+
+    // Snapshot of the positions into a caller-owned buffer; only allocates
+    // when the buffer is too small, so it can be reused from frame to frame.
+    void getPos(std::vector<Vec3f>& pos) const;
+    // Interleaved x, y, z copy into a buffer of 3 * getNumParticles() floats.
+    void copyPositions(float* xyz) const;
+    // Same, into three separate arrays of getNumParticles() floats.
+    void copyPositions(float* x, float* y, float* z) const;
 
     void ApplyForce(Vec3f forceDirection);
     void TimeStep(float stepSize);
 
+    void setConstraintSolver(ConstraintSolver solver);
+    // Sets the compliance of every constraint at once, e.g. to try the XPBD
+    // solver on a scene made without compliances.
+    void setConstraintCompliance(float compliance);
+    // Relaxation passes per TimeStep: at least minIterations, then more
+    // until the largest violation a pass finds is below tolerance, up to
+    // maxIterations. The default runs exactly 5 passes (tolerance 0 never
+    // stops early).
+    void setRelaxationIterations(int minIterations, int maxIterations, float tolerance);
+    int getMinRelaxationIterations() const { return m_minRelaxIter; }
+    int getMaxRelaxationIterations() const { return m_maxRelaxIter; }
+    float getRelaxationTolerance() const { return m_relaxTolerance; }
+    const SolverStats& getLastSolverStats() const { return m_lastSolverStats; }
+
+    // Splits each TimeStep into numSubsteps Verlet steps of stepSize /
+    // numSubsteps, each followed by its own relaxation passes; with a single
+    // pass per substep this is the "small steps" scheme, which converges
+    // better per pass than many passes on one large step. Collision
+    // candidates are still found once per TimeStep, within a radius grown to
+    // cover the motion of the remaining substeps, and forces are applied in
+    // the first substep. Default 1.
+    void setSubsteps(int numSubsteps);
+    int getSubsteps() const { return m_numSubsteps; }
+
+    // Threads used by the parallel parts of the simulation (1 = serial):
+    // integration, the colored and Jacobi solvers and collisions. The
+    // Gauss-Seidel and XPBD solvers stay serial, their sweep is sequential.
+    void setNumThreads(int numThreads);
+    // Uses an existing pool instead, e.g. one set up with core pinning or
+    // the static schedule, or shared with other systems. Systems stepped
+    // from different threads then take turns on it. nullptr = serial.
+    void setThreadPool(std::shared_ptr<ThreadPool> threadPool) { m_threadPool = threadPool; }
+    std::shared_ptr<ThreadPool> getThreadPool() const { return m_threadPool; }
+    int getNumConstraintColors() const { return m_numParallelColors; }
+    // Levels coarser than the cloth built for the multigrid solver, 0 while
+    // another solver is selected.
+    int getNumCoarseLevels() const { return m_constraintLevels.size(); }
+
+    // Keeps particles of the cloth at least thickness apart. The thickness
+    // has to be below the rest length of the constraints, or constraints and
+    // collisions end up fighting each other, and above about 0.7 times the
+    // particle spacing for particles not to slip through the gaps of a grid.
+    void setSelfCollision(bool enabled, float thickness);
+    bool getSelfCollision() const { return m_selfCollision; }
+    float getSelfCollisionThickness() const { return m_collisionThickness; }
+    // Candidate pairs found by the last TimeStep.
+    unsigned int getNumSelfCollisionPairs() const { return m_collisionPartners.size(); }
+
+    // Static triangle meshes that particles are kept at least thickness
+    // away from. Meshes aren't copied, so one can be shared between systems.
+    void addCollisionMesh(std::shared_ptr<const CollisionMesh> mesh, float thickness);
+    void clearCollisionMeshes();
+    unsigned int getNumCollisionMeshes() const { return m_collisionMeshes.size(); }
+
+    // Analytic colliders, projected with the SIMD kernels in every
+    // relaxation iteration. getColliders() gives write access to move them
+    // between steps, e.g. to follow a character's bones.
+    void addCollider(const SphereCollider& sphere) { m_colliders.spheres.push_back(sphere); }
+    void addCollider(const CapsuleCollider& capsule) { m_colliders.capsules.push_back(capsule); }
+    void addCollider(const BoxCollider& box) { m_colliders.boxes.push_back(box); }
+    void addCollider(const PlaneCollider& plane) { m_colliders.planes.push_back(plane); }
+    void clearColliders() { m_colliders.clear(); }
+    ColliderSet& getColliders() { return m_colliders; }
+    const ColliderSet& getColliders() const { return m_colliders; }
+
+    unsigned int getNumParticles() const { return m_currPos.size(); }
+    unsigned int getNumConstraints() const { return m_constraints.size(); }
+    const StepTimings& getLastStepTimings() const { return m_lastStepTimings; }
+
 private:
 
-    std::vector<Vec3f> m_currPos, m_oldPos, m_forces;
+    ParticleBuffer m_currPos, m_oldPos, m_forces;
     std::vector<Constraint> m_constraints;
-    std::vector<bool> m_isMovable;
+    FloatArray m_invMass; // 0 for particles that can't move
+
+    // after ReorderParticles: original index of each particle and of each
+    // constraint; both empty while the original order is kept
+    std::vector<int> m_originalIndex, m_originalConstraintIndex;
+
+    // m_constraints packed for the Gauss-Seidel solvers, leaving out the
+    // ones between two pinned particles; only one of the index widths is
+    // filled, depending on m_narrowIndices
+    bool m_narrowIndices = false;
+    std::vector<PackedConstraint<uint32_t>> m_packedConstraints;
+    std::vector<PackedConstraint<uint16_t>> m_narrowConstraints;
+
+    // the same, grouped by color: no two constraints of a color share a
+    // particle, so each [m_colorOffsets[k], m_colorOffsets[k + 1]) range can
+    // be solved in parallel
+    std::vector<PackedConstraint<uint32_t>> m_packedColored;
+    std::vector<PackedConstraint<uint16_t>> m_narrowColored;
+    std::vector<int> m_colorOffsets;
+    int m_numParallelColors = 0; // colors past this one are solved serially
+
+    // XPBD solver: m_constraints packed with their inverse masses and
+    // compliances, only while it is the selected solver, and the Lagrange
+    // multiplier of each, accumulated over the passes of a step
+    std::vector<CompliantConstraint<uint32_t>> m_compliantConstraints;
+    std::vector<CompliantConstraint<uint16_t>> m_narrowCompliant;
+    FloatArray m_lambdas;
+
+    // multigrid solver: coarser and coarser levels of the cloth, only while
+    // it is the selected solver
+    std::vector<ConstraintLevel> m_constraintLevels;
+
+    // Jacobi solver: per-constraint corrections, gathered per particle through
+    // a CSR adjacency (m_jacobiOffsets[i]..m_jacobiOffsets[i + 1] lists the
+    // constraints of particle i, with their weight already divided by the
+    // particle's constraint count)
+    ParticleBuffer m_corrections;
+    std::vector<int> m_jacobiOffsets, m_jacobiConstraints;
+    FloatArray m_jacobiWeights;
+
+    // self-collision: pairs of particles close enough to touch during the
+    // step are found once per step, as a CSR list of partners j > i of each
+    // particle i, then projected in every relaxation iteration
+    bool m_selfCollision = false;
+    float m_collisionThickness = 0.0f;
+    SpatialHashGrid m_collisionGrid;
+    std::vector<int> m_collisionOffsets, m_collisionPartners;
+    std::vector<std::vector<int>> m_collisionBlocks;
+    FloatArray m_particleMotion; // with substeps, motion in the first one
+
+    // constraint violations found by a relaxation pass, summed over the
+    // chunks of the parallel loops
+    struct Violation {
+        float max = 0.0f;
+        double sumSquares = 0.0;
+    };
+
+    // collision meshes: each particle gets at most one contact per step, a
+    // plane dot(normal, p) >= offset that every relaxation iteration
+    // enforces; particles without contact have a zero normal and offset
+    struct MeshCollider {
+        std::shared_ptr<const CollisionMesh> mesh;
+        float thickness;
+    };
+    std::vector<MeshCollider> m_collisionMeshes;
+    ParticleBuffer m_contactNormals;
+    FloatArray m_contactOffsets;
+
+    ColliderSet m_colliders;
+
+    ConstraintSolver m_solver = ConstraintSolver::GaussSeidel;
+    int m_numSubsteps = 1;
+    int m_minRelaxIter = 5, m_maxRelaxIter = 5;
+    float m_relaxTolerance = 0.0f;
+    SolverStats m_lastSolverStats;
+    StepTimings m_lastStepTimings;
+    std::shared_ptr<ThreadPool> m_threadPool;
+
+    void Initialize();
+    void PackConstraints();
+    void ColorConstraints();
+    void BuildJacobiAdjacency();
+    void PermuteParticles(const std::vector<int>& order);
+    void ParallelFor(int count, const std::function<void(int, int)>& task, int grainSize = 1);
 
     void AccumulateForces(float stepSize);
     void Verlet(float stepSize);
-    void SatisfyConstraints();
+    void SatisfyConstraints(float stepSize);
+    template<typename Index>
+    void SolveConstraintsGaussSeidel(const std::vector<PackedConstraint<Index>>& constraints,
+                                     const std::vector<PackedConstraint<Index>>& colored,
+                                     Violation* violation);
+    void SolveConstraintsJacobi(Violation* violation);
+    void SolveCoarseLevels();
+    template<typename Index>
+    void SolveConstraintsXpbd(const std::vector<CompliantConstraint<Index>>& constraints,
+                              float stepSize, Violation* violation);
+    float ComputeParticleMotion();
+    void FindSelfCollisions(int numSubsteps);
+    void SolveSelfCollisions();
+    void FindMeshContacts(int numSubsteps);
+    void SolveMeshContacts();
+    void SolveColliders();
 };
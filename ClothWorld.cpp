@@ -0,0 +1,115 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+
+#include "ClothWorld.hpp"
+#include "Profiler.hpp"
+
+ClothWorld::ClothWorld()
+{
+}
+
+ClothSimulationSystem& ClothWorld::AddCloth(ClothSimulationSystem&& cloth)
+{
+    m_cloths.push_back(std::make_unique<ClothSimulationSystem>(std::move(cloth)));
+    m_cloths.back()->setThreadPool(m_threadPool);
+    return *m_cloths.back();
+}
+
+void ClothWorld::RemoveCloth(unsigned int clothIdx)
+{
+    m_cloths.erase(m_cloths.begin() + clothIdx);
+}
+
+void ClothWorld::Clear()
+{
+    m_cloths.clear();
+    m_pendingForces.clear();
+}
+
+unsigned int ClothWorld::getNumParticles() const
+{
+    unsigned int numParticles = 0;
+    for(unsigned int i = 0; i < m_cloths.size(); i++)
+    {
+        numParticles += m_cloths[i]->getNumParticles();
+    }
+    return numParticles;
+}
+
+void ClothWorld::setNumThreads(int numThreads)
+{
+    if(numThreads <= 1)
+    {
+        setThreadPool(nullptr);
+    }
+    else if(!m_threadPool || m_threadPool->getNumThreads() != numThreads)
+    {
+        setThreadPool(std::make_shared<ThreadPool>(numThreads));
+    }
+}
+
+void ClothWorld::setThreadPool(std::shared_ptr<ThreadPool> threadPool)
+{
+    m_threadPool = threadPool;
+    for(unsigned int i = 0; i < m_cloths.size(); i++)
+    {
+        m_cloths[i]->setThreadPool(threadPool);
+    }
+}
+
+void ClothWorld::ApplyForce(Vec3f forceDirection)
+{
+    m_pendingForces.push_back(forceDirection);
+}
+
+void ClothWorld::TimeStep(float stepSize)
+{
+    CLOTH_PROFILE_SCOPE("world_step");
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // forces are applied one by one, in order, exactly as separate
+    // ApplyForce calls on each cloth would
+    std::function<void(int, int)> stepCloths = [&](int begin, int end)
+    {
+        for(int i = begin; i < end; i++)
+        {
+            for(unsigned int f = 0; f < m_pendingForces.size(); f++)
+            {
+                m_cloths[i]->ApplyForce(m_pendingForces[f]);
+            }
+            m_cloths[i]->TimeStep(stepSize);
+        }
+    };
+
+    if(m_threadPool)
+    {
+        m_threadPool->ParallelFor(m_cloths.size(), stepCloths);
+    }
+    else if(!m_cloths.empty())
+    {
+        stepCloths(0, m_cloths.size());
+    }
+    m_pendingForces.clear();
+
+    WorldStepTimings timings;
+    for(unsigned int i = 0; i < m_cloths.size(); i++)
+    {
+        const StepTimings& cloth = m_cloths[i]->getLastStepTimings();
+        timings.cloths.accumulateForcesNs += cloth.accumulateForcesNs;
+        timings.cloths.verletNs += cloth.verletNs;
+        timings.cloths.collisionDetectionNs += cloth.collisionDetectionNs;
+        timings.cloths.satisfyConstraintsNs += cloth.satisfyConstraintsNs;
+        timings.cloths.collidersNs += cloth.collidersNs;
+
+        double clothNs = cloth.accumulateForcesNs + cloth.verletNs +
+                         cloth.collisionDetectionNs + cloth.satisfyConstraintsNs;
+        timings.slowestClothNs = std::max(timings.slowestClothNs, clothNs);
+    }
+    timings.wallNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    m_lastStepTimings = timings;
+}
@@ -0,0 +1,63 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ClothSimulationSystem.hpp"
+#include "ThreadPool.hpp"
+#include "Vec3.hpp"
+
+// Timings of the last ClothWorld::TimeStep, in nanoseconds.
+struct WorldStepTimings {
+    double wallNs = 0.0;         // the whole step, as seen by the caller
+    double slowestClothNs = 0.0; // longest single cloth step
+    StepTimings cloths;          // each phase summed over all cloths
+};
+
+// Independent cloths (capes, flags...) stepped together: each cloth has its
+// own buffers and solver, and a TimeStep spreads the cloths over the
+// threads of the world's pool. Cloths share that pool for their own
+// parallel loops, which then only run in parallel when the world has a
+// single cloth to step.
+class ClothWorld
+{
+
+public:
+
+    ClothWorld();
+
+    // Takes over a cloth and returns it, at an address that stays valid
+    // until it is removed. The cloth's thread pool is replaced by the world's.
+    ClothSimulationSystem& AddCloth(ClothSimulationSystem&& cloth);
+    void RemoveCloth(unsigned int clothIdx);
+    void Clear();
+
+    unsigned int getNumCloths() const { return m_cloths.size(); }
+    ClothSimulationSystem& getCloth(unsigned int clothIdx) { return *m_cloths[clothIdx]; }
+    const ClothSimulationSystem& getCloth(unsigned int clothIdx) const { return *m_cloths[clothIdx]; }
+    unsigned int getNumParticles() const;
+
+    // Same as ClothSimulationSystem's, for all the cloths of the world.
+    void setNumThreads(int numThreads);
+    void setThreadPool(std::shared_ptr<ThreadPool> threadPool);
+    std::shared_ptr<ThreadPool> getThreadPool() const { return m_threadPool; }
+
+    // Applies a force to every cloth at the start of the next TimeStep;
+    // forces for a single cloth go through getCloth(i).ApplyForce().
+    void ApplyForce(Vec3f forceDirection);
+    void TimeStep(float stepSize);
+
+    const WorldStepTimings& getLastStepTimings() const { return m_lastStepTimings; }
+
+private:
+
+    std::vector<std::unique_ptr<ClothSimulationSystem>> m_cloths;
+    std::vector<Vec3f> m_pendingForces;
+    std::shared_ptr<ThreadPool> m_threadPool;
+    WorldStepTimings m_lastStepTimings;
+};
@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+
+#include "Vec3.hpp"
+
+// Analytic shapes that particles are pushed out of, cheap enough to build a
+// character out of a few dozen of them (a capsule per bone, a box for the
+// chest...). They are plain data: moving a collider between steps is just
+// changing its fields.
+
+struct SphereCollider {
+    Vec3f center;
+    float radius;
+};
+
+// Every point closer than radius to the segment [a, b].
+struct CapsuleCollider {
+    Vec3f a, b;
+    float radius;
+};
+
+// Oriented box: axes must be orthonormal, and halfExtents[k] is the half size
+// of the box along axes[k]. Particles inside are pushed out through the
+// closest face.
+struct BoxCollider {
+    Vec3f center;
+    Vec3f axes[3];
+    Vec3f halfExtents;
+};
+
+// Half-space below an infinite plane: keeps dot(normal, p) >= offset, with a
+// unit normal.
+struct PlaneCollider {
+    Vec3f normal;
+    float offset;
+};
+
+struct ColliderSet {
+    std::vector<SphereCollider> spheres;
+    std::vector<CapsuleCollider> capsules;
+    std::vector<BoxCollider> boxes;
+    std::vector<PlaneCollider> planes;
+
+    bool empty() const
+    {
+        return spheres.empty() && capsules.empty() && boxes.empty() && planes.empty();
+    }
+
+    unsigned int size() const
+    {
+        return spheres.size() + capsules.size() + boxes.size() + planes.size();
+    }
+
+    void clear()
+    {
+        spheres.clear();
+        capsules.clear();
+        boxes.clear();
+        planes.clear();
+    }
+};
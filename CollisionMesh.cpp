@@ -0,0 +1,327 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <math.h>
+#include <algorithm>
+
+#include "CollisionMesh.hpp"
+
+static const int numSahBins = 16;
+static const int maxLeafTriangles = 8;
+// keeps the traversal stack of FindContact bounded
+static const int maxDepth = 60;
+
+struct CollisionMesh::BuildTriangle {
+    float min[3], max[3];
+    float centroid[3];
+    int index;
+};
+
+struct Bounds {
+    float min[3] = { INFINITY, INFINITY, INFINITY };
+    float max[3] = { -INFINITY, -INFINITY, -INFINITY };
+
+    void Grow(const float* otherMin, const float* otherMax)
+    {
+        for(int k = 0; k < 3; k++)
+        {
+            min[k] = std::min(min[k], otherMin[k]);
+            max[k] = std::max(max[k], otherMax[k]);
+        }
+    }
+
+    float area() const
+    {
+        float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+        return dx < 0.0f ? 0.0f : dx * dy + dy * dz + dz * dx;
+    }
+};
+
+CollisionMesh::CollisionMesh(const std::vector<Vec3f>& vertices, const std::vector<int>& triangles)
+{
+    std::vector<BuildTriangle> build;
+    std::vector<Triangle> source;
+    build.reserve(triangles.size() / 3);
+    source.reserve(triangles.size() / 3);
+
+    for(unsigned int t = 0; t + 2 < triangles.size(); t += 3)
+    {
+        Triangle tri;
+        tri.a = vertices[triangles[t + 0]];
+        tri.b = vertices[triangles[t + 1]];
+        tri.c = vertices[triangles[t + 2]];
+
+        Vec3f normal = (tri.b - tri.a).cross(tri.c - tri.a);
+        if(!(normal.dot(normal) > 0.0f))
+        {
+            continue; // degenerate, has no side to push particles to
+        }
+        tri.normal = normal.normalize();
+
+        BuildTriangle b;
+        for(int k = 0; k < 3; k++)
+        {
+            b.min[k] = std::min(std::min(tri.a[k], tri.b[k]), tri.c[k]);
+            b.max[k] = std::max(std::max(tri.a[k], tri.b[k]), tri.c[k]);
+            b.centroid[k] = (tri.a[k] + tri.b[k] + tri.c[k]) / 3.0f;
+        }
+        b.index = source.size();
+
+        source.push_back(tri);
+        build.push_back(b);
+    }
+
+    if(build.empty())
+    {
+        return;
+    }
+
+    m_nodes.reserve(2 * build.size());
+    m_nodes.resize(1);
+    Subdivide(0, build, 0, build.size(), 0);
+
+    m_triangles.resize(build.size());
+    for(unsigned int i = 0; i < build.size(); i++)
+    {
+        m_triangles[i] = source[build[i].index];
+    }
+}
+
+void CollisionMesh::Subdivide(int nodeIdx, std::vector<BuildTriangle>& build, int first, int count,
+                              int depth)
+{
+    Bounds bounds, centroids;
+    for(int i = first; i < first + count; i++)
+    {
+        bounds.Grow(build[i].min, build[i].max);
+        centroids.Grow(build[i].centroid, build[i].centroid);
+    }
+
+    Node& node = m_nodes[nodeIdx];
+    for(int k = 0; k < 3; k++)
+    {
+        node.min[k] = bounds.min[k];
+        node.max[k] = bounds.max[k];
+    }
+    node.leftFirst = first;
+    node.count = count;
+
+    if(count <= 2 || depth >= maxDepth)
+    {
+        return;
+    }
+
+    // binned SAH: the cost of a split is the expected number of triangles
+    // tested, in units of one triangle test, relative to this node's area
+    float bestCost = INFINITY;
+    int bestAxis = -1, bestSplit = 0;
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        float extent = centroids.max[axis] - centroids.min[axis];
+        if(!(extent > 0.0f))
+        {
+            continue;
+        }
+
+        Bounds bins[numSahBins];
+        int binCounts[numSahBins] = { 0 };
+        float scale = numSahBins / extent;
+
+        for(int i = first; i < first + count; i++)
+        {
+            int bin = std::min(numSahBins - 1,
+                               static_cast<int>((build[i].centroid[axis] - centroids.min[axis]) * scale));
+            bins[bin].Grow(build[i].min, build[i].max);
+            binCounts[bin]++;
+        }
+
+        // areas and counts on the right of each split, swept from the end
+        float rightAreas[numSahBins];
+        int rightCounts[numSahBins];
+        Bounds right;
+        int rightCount = 0;
+        for(int b = numSahBins - 1; b > 0; b--)
+        {
+            right.Grow(bins[b].min, bins[b].max);
+            rightCount += binCounts[b];
+            rightAreas[b] = right.area();
+            rightCounts[b] = rightCount;
+        }
+
+        Bounds left;
+        int leftCount = 0;
+        for(int b = 1; b < numSahBins; b++)
+        {
+            left.Grow(bins[b - 1].min, bins[b - 1].max);
+            leftCount += binCounts[b - 1];
+            if(leftCount == 0 || rightCounts[b] == 0)
+            {
+                continue;
+            }
+
+            float cost = left.area() * leftCount + rightAreas[b] * rightCounts[b];
+            if(cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b;
+            }
+        }
+    }
+
+    const float leafCost = count;
+    const float splitCost = 1.0f + bestCost / bounds.area();
+    if(bestAxis < 0 || (count <= maxLeafTriangles && splitCost >= leafCost))
+    {
+        return;
+    }
+
+    const float splitMin = centroids.min[bestAxis];
+    const float splitScale = numSahBins / (centroids.max[bestAxis] - splitMin);
+    BuildTriangle* middle = std::partition(&build[first], &build[first] + count,
+        [&](const BuildTriangle& t)
+        {
+            int bin = std::min(numSahBins - 1,
+                               static_cast<int>((t.centroid[bestAxis] - splitMin) * splitScale));
+            return bin < bestSplit;
+        });
+    int leftCount = middle - &build[first];
+
+    int left = m_nodes.size();
+    m_nodes.resize(left + 2);
+    m_nodes[nodeIdx].leftFirst = left;
+    m_nodes[nodeIdx].count = 0;
+
+    Subdivide(left, build, first, leftCount, depth + 1);
+    Subdivide(left + 1, build, first + leftCount, count - leftCount, depth + 1);
+}
+
+// Ericson, Real-Time Collision Detection, 5.1.5
+static Vec3f closestPointOnTriangle(const Vec3f& p, const Vec3f& a, const Vec3f& b, const Vec3f& c)
+{
+    Vec3f ab = b - a, ac = c - a, ap = p - a;
+    float d1 = ab.dot(ap), d2 = ac.dot(ap);
+    if(d1 <= 0.0f && d2 <= 0.0f)
+    {
+        return a;
+    }
+
+    Vec3f bp = p - b;
+    float d3 = ab.dot(bp), d4 = ac.dot(bp);
+    if(d3 >= 0.0f && d4 <= d3)
+    {
+        return b;
+    }
+
+    float vc = d1 * d4 - d3 * d2;
+    if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+    {
+        return a + ab * (d1 / (d1 - d3));
+    }
+
+    Vec3f cp = p - c;
+    float d5 = ab.dot(cp), d6 = ac.dot(cp);
+    if(d6 >= 0.0f && d5 <= d6)
+    {
+        return c;
+    }
+
+    float vb = d5 * d2 - d1 * d6;
+    if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+    {
+        return a + ac * (d2 / (d2 - d6));
+    }
+
+    float va = d3 * d6 - d5 * d4;
+    if(va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+    {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+static inline float boxDistanceSq(const float* min, const float* max, const Vec3f& p)
+{
+    float distanceSq = 0.0f;
+    for(int k = 0; k < 3; k++)
+    {
+        float d = std::max(std::max(min[k] - p[k], p[k] - max[k]), 0.0f);
+        distanceSq += d * d;
+    }
+    return distanceSq;
+}
+
+bool CollisionMesh::FindContact(const Vec3f& p, float maxDistance, Vec3f& point, Vec3f& direction) const
+{
+    if(m_nodes.empty())
+    {
+        return false;
+    }
+
+    float bestSq = maxDistance * maxDistance;
+    int best = -1;
+    bool bestInFront = false;
+
+    int stack[maxDepth + 4];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while(stackSize > 0)
+    {
+        const Node& node = m_nodes[stack[--stackSize]];
+
+        if(node.count > 0)
+        {
+            for(int t = node.leftFirst; t < node.leftFirst + node.count; t++)
+            {
+                const Triangle& tri = m_triangles[t];
+                Vec3f q = closestPointOnTriangle(p, tri.a, tri.b, tri.c);
+                Vec3f delta = p - q;
+                float distanceSq = delta.dot(delta);
+                bool inFront = delta.dot(tri.normal) > 0.0f;
+
+                // on an edge shared by two triangles, the one p is in front
+                // of tells which side of the mesh p is on
+                if(distanceSq < bestSq || (distanceSq <= bestSq && inFront && !bestInFront))
+                {
+                    bestSq = distanceSq;
+                    best = t;
+                    bestInFront = inFront;
+                    point = q;
+                }
+            }
+            continue;
+        }
+
+        // visit the closer child first, it's more likely to shrink bestSq
+        int left = node.leftFirst;
+        float leftSq = boxDistanceSq(m_nodes[left].min, m_nodes[left].max, p);
+        float rightSq = boxDistanceSq(m_nodes[left + 1].min, m_nodes[left + 1].max, p);
+        int nearChild = leftSq <= rightSq ? left : left + 1;
+        float nearSq = std::min(leftSq, rightSq), farSq = std::max(leftSq, rightSq);
+
+        if(farSq <= bestSq)
+        {
+            stack[stackSize++] = nearChild == left ? left + 1 : left;
+        }
+        if(nearSq <= bestSq)
+        {
+            stack[stackSize++] = nearChild;
+        }
+    }
+
+    if(best < 0)
+    {
+        return false;
+    }
+
+    Vec3f delta = p - point;
+    float distanceSq = delta.dot(delta);
+    direction = bestInFront && distanceSq > 0.0f ? delta / sqrt(distanceSq) : m_triangles[best].normal;
+    return true;
+}
@@ -0,0 +1,56 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+
+#include "Vec3.hpp"
+
+// Static triangle mesh that cloth can collide with (character bodies,
+// furniture...), with a bounding volume hierarchy built with the surface
+// area heuristic. Triangles have to face outwards, i.e. be counter-clockwise
+// seen from outside.
+class CollisionMesh
+{
+
+public:
+
+    // triangles holds 3 vertex indices per triangle, as loadObj returns them.
+    CollisionMesh(const std::vector<Vec3f>& vertices, const std::vector<int>& triangles);
+
+    // Looks for the closest point of the mesh to p that is less than
+    // maxDistance away. direction is the unit vector to push p along to get
+    // it out of the mesh: away from the closest point if p is in front of
+    // its triangle, or the triangle's normal if p is behind it.
+    bool FindContact(const Vec3f& p, float maxDistance, Vec3f& point, Vec3f& direction) const;
+
+    unsigned int getNumTriangles() const { return m_triangles.size(); }
+    unsigned int getNumNodes() const { return m_nodes.size(); }
+
+private:
+
+    // 32 bytes, so that both children of a node (stored next to each other)
+    // share a cache line. Leaves have count > 0 triangles from leftFirst on;
+    // inner nodes have count == 0 and children leftFirst and leftFirst + 1.
+    struct Node {
+        float min[3];
+        int leftFirst;
+        float max[3];
+        int count;
+    };
+
+    // in leaf order, so the triangles of a leaf are contiguous
+    struct Triangle {
+        Vec3f a, b, c;
+        Vec3f normal;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<Triangle> m_triangles;
+
+    struct BuildTriangle;
+    void Subdivide(int nodeIdx, std::vector<BuildTriangle>& build, int first, int count, int depth);
+};
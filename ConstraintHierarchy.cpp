@@ -0,0 +1,261 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <math.h>
+#include <algorithm>
+
+#include "ClothSimulationSystem.hpp"
+#include "ConstraintHierarchy.hpp"
+
+// A level that keeps more than this fraction of the particles of the finer
+// one costs about as much to relax as it saves.
+static const float maxCoarseningRatio = 0.75f;
+
+struct GraphEdge {
+    int a, b;
+    float length;
+};
+
+// Symmetric adjacency of a level, as CSR, with the length of each edge.
+struct LevelGraph {
+    std::vector<int> offsets, neighbors;
+    std::vector<float> lengths;
+};
+
+static void buildGraph(int numNodes, const std::vector<GraphEdge>& edges, LevelGraph& graph)
+{
+    graph.offsets.assign(numNodes + 1, 0);
+    for(unsigned int i = 0; i < edges.size(); i++)
+    {
+        graph.offsets[edges[i].a + 1]++;
+        graph.offsets[edges[i].b + 1]++;
+    }
+    for(int i = 0; i < numNodes; i++)
+    {
+        graph.offsets[i + 1] += graph.offsets[i];
+    }
+
+    std::vector<int> fill(graph.offsets.begin(), graph.offsets.end() - 1);
+    graph.neighbors.resize(graph.offsets[numNodes]);
+    graph.lengths.resize(graph.offsets[numNodes]);
+    for(unsigned int i = 0; i < edges.size(); i++)
+    {
+        const GraphEdge& e = edges[i];
+        graph.neighbors[fill[e.a]] = e.b;
+        graph.lengths[fill[e.a]++] = e.length;
+        graph.neighbors[fill[e.b]] = e.a;
+        graph.lengths[fill[e.b]++] = e.length;
+    }
+}
+
+void buildConstraintHierarchy(const FloatArray& invMass, const std::vector<Constraint>& constraints,
+                              int minParticles, std::vector<ConstraintLevel>& levels)
+{
+    levels.clear();
+
+    // the current level: particle of each node, and the edges between nodes
+    std::vector<int> ids(invMass.size());
+    for(unsigned int i = 0; i < ids.size(); i++)
+    {
+        ids[i] = i;
+    }
+
+    std::vector<GraphEdge> edges;
+    edges.reserve(constraints.size());
+    for(unsigned int i = 0; i < constraints.size(); i++)
+    {
+        const Constraint& c = constraints[i];
+        if(c.idxA != c.idxB)
+        {
+            GraphEdge e = { c.idxA, c.idxB, c.restlength };
+            edges.push_back(e);
+        }
+    }
+
+    LevelGraph graph;
+    std::vector<int> coarseIndex;
+    std::vector<int> parentOffsets, parents;
+    std::vector<float> parentLengths;
+    std::vector<float> best;
+    std::vector<int> touched;
+    std::vector<GraphEdge> coarseEdges;
+
+    while(static_cast<int>(ids.size()) > minParticles)
+    {
+        const int numNodes = ids.size();
+        buildGraph(numNodes, edges, graph);
+
+        // greedy maximal independent set, pinned particles first
+        std::vector<bool> blocked(numNodes, false);
+        coarseIndex.assign(numNodes, -1);
+        for(int pass = 0; pass < 2; pass++)
+        {
+            for(int v = 0; v < numNodes; v++)
+            {
+                bool pinned = invMass[ids[v]] <= 0.0f;
+                if(blocked[v] || pinned != (pass == 0))
+                {
+                    continue;
+                }
+
+                coarseIndex[v] = 0;
+                blocked[v] = true;
+                for(int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++)
+                {
+                    blocked[graph.neighbors[k]] = true;
+                }
+            }
+        }
+
+        ConstraintLevel level;
+        for(int v = 0; v < numNodes; v++)
+        {
+            if(coarseIndex[v] >= 0)
+            {
+                coarseIndex[v] = level.particles.size();
+                level.particles.push_back(ids[v]);
+            }
+        }
+
+        const int numCoarse = level.particles.size();
+        if(numCoarse < 2 || numCoarse > maxCoarseningRatio * numNodes)
+        {
+            break;
+        }
+
+        // parents of every other node: its coarse neighbors, each with the
+        // shortest edge to it
+        parentOffsets.assign(numNodes + 1, 0);
+        parents.clear();
+        parentLengths.clear();
+        for(int v = 0; v < numNodes; v++)
+        {
+            for(int k = graph.offsets[v]; k < graph.offsets[v + 1] && coarseIndex[v] < 0; k++)
+            {
+                int p = coarseIndex[graph.neighbors[k]];
+                if(p < 0)
+                {
+                    continue;
+                }
+
+                int j = parentOffsets[v];
+                while(j < static_cast<int>(parents.size()) && parents[j] != p)
+                {
+                    j++;
+                }
+                if(j == static_cast<int>(parents.size()))
+                {
+                    parents.push_back(p);
+                    parentLengths.push_back(graph.lengths[k]);
+                }
+                parentLengths[j] = std::min(parentLengths[j], graph.lengths[k]);
+            }
+            parentOffsets[v + 1] = parents.size();
+        }
+
+        level.parentOffsets.push_back(0);
+        for(int v = 0; v < numNodes; v++)
+        {
+            if(coarseIndex[v] >= 0 || invMass[ids[v]] <= 0.0f)
+            {
+                continue;
+            }
+
+            float sum = 0.0f;
+            for(int j = parentOffsets[v]; j < parentOffsets[v + 1]; j++)
+            {
+                sum += 1.0f / std::max(parentLengths[j], 1.0e-6f);
+            }
+
+            level.fineParticles.push_back(ids[v]);
+            for(int j = parentOffsets[v]; j < parentOffsets[v + 1]; j++)
+            {
+                level.parents.push_back(parents[j]);
+                level.parentWeights.push_back(1.0f / std::max(parentLengths[j], 1.0e-6f) / sum);
+            }
+            level.parentOffsets.push_back(level.parents.size());
+        }
+
+        // coarse nodes are connected when at most two other nodes lie
+        // between them (p - f - q or p - f - g - q), by the shortest such
+        // chain; independent set nodes are never neighbors
+        best.assign(numCoarse, INFINITY);
+        coarseEdges.clear();
+        for(int v = 0; v < numNodes; v++)
+        {
+            const int p = coarseIndex[v];
+            if(p < 0)
+            {
+                continue;
+            }
+
+            touched.clear();
+            auto reach = [&](int q, float length)
+            {
+                if(q <= p)
+                {
+                    return;
+                }
+                if(std::isinf(best[q]))
+                {
+                    touched.push_back(q);
+                }
+                best[q] = std::min(best[q], length);
+            };
+
+            for(int k = graph.offsets[v]; k < graph.offsets[v + 1]; k++)
+            {
+                int f = graph.neighbors[k];
+                float lengthF = graph.lengths[k];
+
+                for(int j = parentOffsets[f]; j < parentOffsets[f + 1]; j++)
+                {
+                    reach(parents[j], lengthF + parentLengths[j]);
+                }
+
+                for(int k2 = graph.offsets[f]; k2 < graph.offsets[f + 1]; k2++)
+                {
+                    int g = graph.neighbors[k2];
+                    float lengthG = lengthF + graph.lengths[k2];
+                    for(int j = parentOffsets[g]; j < parentOffsets[g + 1]; j++)
+                    {
+                        reach(parents[j], lengthG + parentLengths[j]);
+                    }
+                }
+            }
+
+            std::sort(touched.begin(), touched.end());
+            for(unsigned int t = 0; t < touched.size(); t++)
+            {
+                GraphEdge e = { p, touched[t], best[touched[t]] };
+                coarseEdges.push_back(e);
+                best[touched[t]] = INFINITY;
+            }
+        }
+
+        for(unsigned int i = 0; i < coarseEdges.size(); i++)
+        {
+            CoarseConstraint c;
+            c.idxA = level.particles[coarseEdges[i].a];
+            c.idxB = level.particles[coarseEdges[i].b];
+            c.maxLength = coarseEdges[i].length;
+
+            bool movableA = invMass[c.idxA] > 0.0f;
+            bool movableB = invMass[c.idxB] > 0.0f;
+            if(!movableA && !movableB)
+            {
+                continue;
+            }
+            c.weightA = movableA ? (movableB ? 0.5f : 1.0f) : 0.0f;
+            c.weightB = movableB ? (movableA ? 0.5f : 1.0f) : 0.0f;
+            level.constraints.push_back(c);
+        }
+
+        level.motion.resize(numCoarse);
+        ids = level.particles;
+        edges.swap(coarseEdges);
+        levels.push_back(std::move(level));
+    }
+}
@@ -0,0 +1,50 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+
+#include "ParticleBuffer.hpp"
+
+struct Constraint;
+
+// Constraint between the particles of a coarse level. It only keeps them
+// from getting further apart than maxLength, the rest length of the
+// shortest chain of finer constraints between them, so that coarse levels
+// pull the cloth taut without keeping it from folding.
+struct CoarseConstraint {
+    int idxA, idxB;
+    float weightA, weightB;
+    float maxLength;
+};
+
+// One level of the multigrid hierarchy: a subset of the particles of the
+// finer level, none two of them constrained together there, such that
+// every other particle has at least one of them as neighbor (its parents).
+// Indices are particle indices of the system unless noted otherwise.
+struct ConstraintLevel {
+    std::vector<int> particles;
+    std::vector<CoarseConstraint> constraints;
+
+    // Prolongation: each movable particle of the finer level that isn't
+    // part of this one follows the motion of its parents, weighted by their
+    // inverse distance. parents[parentOffsets[k]..parentOffsets[k + 1]) are
+    // indices into particles.
+    std::vector<int> fineParticles;
+    std::vector<int> parentOffsets;
+    std::vector<int> parents;
+    FloatArray parentWeights;
+
+    // positions of particles when a relaxation pass starts, then their motion
+    ParticleBuffer motion;
+};
+
+// Coarsens the constraint graph level after level (levels[0] is the
+// first level coarser than the cloth itself), until a level has at most
+// minParticles particles or coarsening stops paying off. Pinned particles
+// are picked first, so coarse levels stay anchored where the cloth is.
+void buildConstraintHierarchy(const FloatArray& invMass, const std::vector<Constraint>& constraints,
+                              int minParticles, std::vector<ConstraintLevel>& levels);
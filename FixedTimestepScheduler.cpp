@@ -0,0 +1,45 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include "FixedTimestepScheduler.hpp"
+
+FixedTimestepScheduler::FixedTimestepScheduler(float stepSize, int substeps, int maxStepsPerFrame)
+{
+    m_stepSize = stepSize;
+    m_substeps = substeps < 1 ? 1 : substeps;
+    m_maxStepsPerFrame = maxStepsPerFrame < 1 ? 1 : maxStepsPerFrame;
+    Reset();
+}
+
+void FixedTimestepScheduler::Reset()
+{
+    m_accumulator = 0.0f;
+    m_droppedTime = 0.0f;
+}
+
+int FixedTimestepScheduler::Advance(float elapsedTime)
+{
+    if(elapsedTime > 0.0f)
+    {
+        m_accumulator += elapsedTime;
+    }
+
+    int numSteps = static_cast<int>(m_accumulator / m_stepSize);
+
+    if(numSteps > m_maxStepsPerFrame)
+    {
+        // spiral of death guard: only keep what's left of the current step
+        m_droppedTime += (numSteps - m_maxStepsPerFrame) * m_stepSize;
+        numSteps = m_maxStepsPerFrame;
+    }
+
+    m_accumulator -= numSteps * m_stepSize;
+    if(m_accumulator >= m_stepSize)
+    {
+        m_accumulator -= static_cast<int>(m_accumulator / m_stepSize) * m_stepSize;
+    }
+
+    return numSteps;
+}
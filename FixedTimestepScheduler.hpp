@@ -0,0 +1,45 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+// Turns variable frame times into a whole number of fixed simulation steps.
+// Elapsed time goes into an accumulator, and each frame runs as many fixed
+// steps as it holds. Each step is split into substeps of stepSize / substeps,
+// e.g. by handing substeps to ClothSimulationSystem::setSubsteps, so that
+// forces are still applied once per step.
+// At most maxStepsPerFrame steps are run per frame: if the simulation can't
+// keep up, the extra time is dropped instead of piling up (which would make
+// every following frame even slower).
+class FixedTimestepScheduler
+{
+
+public:
+
+    FixedTimestepScheduler(float stepSize, int substeps, int maxStepsPerFrame);
+
+    // Adds elapsed time and returns the number of steps to run this frame.
+    int Advance(float elapsedTime);
+    void Reset();
+
+    float getStepSize() const { return m_stepSize; }
+    int getSubsteps() const { return m_substeps; }
+    float getSubstepSize() const { return m_stepSize / m_substeps; }
+
+    // Fraction of a step left in the accumulator, in [0, 1), to interpolate
+    // rendering between the last two steps.
+    float getAlpha() const { return m_accumulator / m_stepSize; }
+    // Total time dropped by the max steps per frame guard since Reset().
+    float getDroppedTime() const { return m_droppedTime; }
+
+private:
+
+    float m_stepSize;
+    int m_substeps;
+    int m_maxStepsPerFrame;
+
+    float m_accumulator;
+    float m_droppedTime;
+};
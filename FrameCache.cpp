@@ -0,0 +1,456 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include "FrameCache.hpp"
+
+static_assert(sizeof(FrameCacheHeader) == 32, "FrameCacheHeader must not have padding");
+static_assert(sizeof(FrameCacheQuantization) == 24, "FrameCacheQuantization must not have padding");
+static_assert(sizeof(FrameCacheIndexEntry) == 24, "FrameCacheIndexEntry must not have padding");
+static_assert(sizeof(FrameCacheFooter) == 24, "FrameCacheFooter must not have padding");
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "frame caches are little-endian and are read without byte swapping"
+#endif
+
+static uint64_t align(uint64_t offset)
+{
+    return (offset + FRAME_CACHE_ALIGNMENT - 1) / FRAME_CACHE_ALIGNMENT * FRAME_CACHE_ALIGNMENT;
+}
+
+static inline float dequantize(float min, float step, uint16_t q)
+{
+    return min + q * step;
+}
+
+// Quantizes values - reference (or values alone if reference is null) over
+// their range, and stores what a reader will decode into decoded.
+static void quantizeAxis(const float* values, const float* reference, int count,
+                         float& min, float& step, uint16_t* quantized, float* decoded)
+{
+    float lo = INFINITY, hi = -INFINITY;
+    for(int i = 0; i < count; i++)
+    {
+        float v = reference ? values[i] - reference[i] : values[i];
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+    }
+    if(count == 0)
+    {
+        lo = hi = 0.0f;
+    }
+
+    min = lo;
+    step = (hi - lo) / 65535.0f;
+    float scale = step > 0.0f ? 1.0f / step : 0.0f;
+
+    for(int i = 0; i < count; i++)
+    {
+        float v = reference ? values[i] - reference[i] : values[i];
+        long q = lrintf((v - lo) * scale);
+        quantized[i] = static_cast<uint16_t>(std::min(std::max(q, 0L), 65535L));
+
+        float d = dequantize(min, step, quantized[i]);
+        decoded[i] = reference ? reference[i] + d : d;
+    }
+}
+
+FrameCacheWriter::FrameCacheWriter()
+{
+    m_open = false;
+    m_numParticles = 0;
+    m_numFrames = 0;
+    m_numStalls = 0;
+    m_writeFailed = false;
+    m_closing = false;
+}
+
+FrameCacheWriter::~FrameCacheWriter()
+{
+    std::string error;
+    Close(error);
+}
+
+bool FrameCacheWriter::Open(const std::string& path, int numParticles,
+                            const FrameCacheOptions& options, std::string& error)
+{
+    if(m_open && !Close(error))
+    {
+        return false;
+    }
+
+    m_file.open(path.c_str(), std::ios::binary | std::ios::trunc);
+    if(!m_file)
+    {
+        error = "can't open '" + path + "' for writing";
+        return false;
+    }
+
+    m_path = path;
+    m_numParticles = numParticles;
+    m_numFrames = 0;
+    m_numStalls = 0;
+    m_options = options;
+    m_options.keyframeInterval = std::max(options.keyframeInterval, 1);
+    m_options.maxQueuedFrames = std::max(options.maxQueuedFrames, 1);
+
+    FrameCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FRAME_CACHE_MAGIC, sizeof(header.magic));
+    header.version = FRAME_CACHE_VERSION;
+    header.headerSize = sizeof(FrameCacheHeader);
+    header.numParticles = numParticles;
+    header.encoding = m_options.encoding;
+    header.keyframeInterval = m_options.encoding == FRAME_CACHE_QUANTIZED_DELTA ?
+                              m_options.keyframeInterval : 1;
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    m_index.clear();
+    m_decoded.resize(numParticles);
+    m_quantized.resize(3 * numParticles);
+    m_writeFailed = false;
+    m_closing = false;
+    m_open = true;
+
+    m_ioThread = std::thread(&FrameCacheWriter::IoLoop, this);
+    return true;
+}
+
+void FrameCacheWriter::PushFrame(const ClothSimulationSystem& system, double time)
+{
+    if(!m_open || static_cast<int>(system.getNumParticles()) != m_numParticles)
+    {
+        return;
+    }
+
+    PendingFrame frame;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(!m_freeFrames.empty())
+        {
+            frame = std::move(m_freeFrames.back());
+            m_freeFrames.pop_back();
+        }
+    }
+
+    frame.pos.resize(m_numParticles);
+    system.copyPositions(frame.pos.x.data(), frame.pos.y.data(), frame.pos.z.data());
+    frame.time = time;
+    m_numFrames++;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if(static_cast<int>(m_queue.size()) >= m_options.maxQueuedFrames)
+        {
+            m_numStalls++;
+            m_frameWritten.wait(lock, [&]
+            {
+                return static_cast<int>(m_queue.size()) < m_options.maxQueuedFrames;
+            });
+        }
+        m_queue.push_back(std::move(frame));
+    }
+    m_wakeUp.notify_one();
+}
+
+bool FrameCacheWriter::Close(std::string& error)
+{
+    if(!m_open)
+    {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_wakeUp.notify_one();
+    m_ioThread.join();
+    m_open = false;
+    m_freeFrames.clear();
+
+    static const char padding[FRAME_CACHE_ALIGNMENT] = { 0 };
+    uint64_t position = static_cast<uint64_t>(m_file.tellp());
+
+    FrameCacheFooter footer;
+    memset(&footer, 0, sizeof(footer));
+    footer.indexOffset = align(position);
+    footer.numFrames = m_index.size();
+    memcpy(footer.magic, FRAME_CACHE_FOOTER_MAGIC, sizeof(footer.magic));
+
+    m_file.write(padding, footer.indexOffset - position);
+    m_file.write(reinterpret_cast<const char*>(m_index.data()),
+                 m_index.size() * sizeof(FrameCacheIndexEntry));
+    m_file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    m_file.close();
+
+    if(m_writeFailed || !m_file)
+    {
+        error = "error while writing '" + m_path + "'";
+        return false;
+    }
+    return true;
+}
+
+void FrameCacheWriter::IoLoop()
+{
+    while(true)
+    {
+        PendingFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeUp.wait(lock, [&] { return m_closing || !m_queue.empty(); });
+            if(m_queue.empty())
+            {
+                return;
+            }
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        WriteFrame(frame);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_freeFrames.push_back(std::move(frame));
+        }
+        m_frameWritten.notify_one();
+    }
+}
+
+void FrameCacheWriter::WriteFrame(const PendingFrame& frame)
+{
+    static const char padding[FRAME_CACHE_ALIGNMENT] = { 0 };
+
+    uint64_t position = static_cast<uint64_t>(m_file.tellp());
+    uint64_t offset = align(position);
+    m_file.write(padding, offset - position);
+
+    const int n = m_numParticles;
+    const bool keyframe = m_options.encoding != FRAME_CACHE_QUANTIZED_DELTA ||
+                          m_index.size() % m_options.keyframeInterval == 0;
+
+    FrameCacheIndexEntry entry;
+    entry.offset = offset;
+    entry.flags = keyframe ? FRAME_CACHE_KEYFRAME : 0;
+    entry.time = frame.time;
+
+    if(m_options.encoding == FRAME_CACHE_RAW)
+    {
+        entry.size = 3 * n * sizeof(float);
+        m_file.write(reinterpret_cast<const char*>(frame.pos.x.data()), n * sizeof(float));
+        m_file.write(reinterpret_cast<const char*>(frame.pos.y.data()), n * sizeof(float));
+        m_file.write(reinterpret_cast<const char*>(frame.pos.z.data()), n * sizeof(float));
+    }
+    else
+    {
+        const FloatArray* values[3] = { &frame.pos.x, &frame.pos.y, &frame.pos.z };
+        FloatArray* decoded[3] = { &m_decoded.x, &m_decoded.y, &m_decoded.z };
+
+        // m_decoded is updated in place, so delta frames are taken against
+        // what the reader will see rather than the exact previous frame, and
+        // errors don't add up from one frame to the next
+        FrameCacheQuantization quantization;
+        for(int axis = 0; axis < 3; axis++)
+        {
+            quantizeAxis(values[axis]->data(), keyframe ? nullptr : decoded[axis]->data(), n,
+                         quantization.min[axis], quantization.step[axis],
+                         &m_quantized[axis * n], decoded[axis]->data());
+        }
+
+        entry.size = sizeof(quantization) + 3 * n * sizeof(uint16_t);
+        m_file.write(reinterpret_cast<const char*>(&quantization), sizeof(quantization));
+        m_file.write(reinterpret_cast<const char*>(m_quantized.data()), 3 * n * sizeof(uint16_t));
+    }
+
+    if(!m_file)
+    {
+        m_writeFailed = true;
+    }
+    m_index.push_back(entry);
+}
+
+static uint64_t frameSize(const FrameCacheHeader& header)
+{
+    if(header.encoding == FRAME_CACHE_RAW)
+    {
+        return 3 * static_cast<uint64_t>(header.numParticles) * sizeof(float);
+    }
+    return sizeof(FrameCacheQuantization) + 3 * static_cast<uint64_t>(header.numParticles) * sizeof(uint16_t);
+}
+
+// Decodes a quantized frame into x, y and z, adding it to what they hold
+// already if it's a delta frame.
+static void dequantizeFrame(const unsigned char* data, int count, bool delta,
+                            float* x, float* y, float* z)
+{
+    const FrameCacheQuantization* quantization = reinterpret_cast<const FrameCacheQuantization*>(data);
+    const uint16_t* quantized = reinterpret_cast<const uint16_t*>(data + sizeof(FrameCacheQuantization));
+    float* decoded[3] = { x, y, z };
+
+    for(int axis = 0; axis < 3; axis++)
+    {
+        const float min = quantization->min[axis], step = quantization->step[axis];
+        const uint16_t* q = quantized + axis * count;
+        float* out = decoded[axis];
+
+        for(int i = 0; i < count; i++)
+        {
+            float d = dequantize(min, step, q[i]);
+            out[i] = delta ? out[i] + d : d;
+        }
+    }
+}
+
+FrameCacheReader::FrameCacheReader()
+{
+    memset(&m_header, 0, sizeof(m_header));
+    m_index = nullptr;
+    m_numFrames = 0;
+    m_decodedFrame = -1;
+}
+
+void FrameCacheReader::Close()
+{
+    m_file.Close();
+    memset(&m_header, 0, sizeof(m_header));
+    m_index = nullptr;
+    m_numFrames = 0;
+    m_decodedFrame = -1;
+}
+
+bool FrameCacheReader::Open(const std::string& path, std::string& error)
+{
+    Close();
+
+    if(!m_file.Open(path, error))
+    {
+        return false;
+    }
+
+    FrameCacheFooter footer;
+    if(m_file.size() < sizeof(m_header) + sizeof(footer))
+    {
+        error = "'" + path + "' is too small to be a frame cache";
+        Close();
+        return false;
+    }
+    memcpy(&m_header, m_file.data(), sizeof(m_header));
+    memcpy(&footer, m_file.data() + m_file.size() - sizeof(footer), sizeof(footer));
+
+    if(memcmp(m_header.magic, FRAME_CACHE_MAGIC, sizeof(m_header.magic)) != 0)
+    {
+        error = "'" + path + "' is not a frame cache";
+        Close();
+        return false;
+    }
+    if(m_header.version != FRAME_CACHE_VERSION || m_header.headerSize != sizeof(FrameCacheHeader) ||
+       m_header.encoding > FRAME_CACHE_QUANTIZED_DELTA)
+    {
+        error = "'" + path + "' has unsupported version " + std::to_string(m_header.version);
+        Close();
+        return false;
+    }
+    // the footer is written last, when the writer is closed
+    if(memcmp(footer.magic, FRAME_CACHE_FOOTER_MAGIC, sizeof(footer.magic)) != 0)
+    {
+        error = "'" + path + "' was not closed properly";
+        Close();
+        return false;
+    }
+
+    const uint64_t indexEnd = m_file.size() - sizeof(footer);
+    const uint64_t indexSize = footer.numFrames * static_cast<uint64_t>(sizeof(FrameCacheIndexEntry));
+    if(footer.indexOffset % FRAME_CACHE_ALIGNMENT != 0 || footer.indexOffset > indexEnd ||
+       indexSize != indexEnd - footer.indexOffset)
+    {
+        error = "'" + path + "' is truncated or corrupted";
+        Close();
+        return false;
+    }
+
+    const FrameCacheIndexEntry* index = reinterpret_cast<const FrameCacheIndexEntry*>(
+                                        m_file.data() + footer.indexOffset);
+    const uint64_t size = frameSize(m_header);
+    for(uint32_t i = 0; i < footer.numFrames; i++)
+    {
+        bool keyframe = index[i].flags & FRAME_CACHE_KEYFRAME;
+        if(index[i].size != size || index[i].offset % FRAME_CACHE_ALIGNMENT != 0 ||
+           index[i].offset > footer.indexOffset || size > footer.indexOffset - index[i].offset ||
+           (i == 0 && !keyframe) || (m_header.encoding != FRAME_CACHE_QUANTIZED_DELTA && !keyframe))
+        {
+            error = "'" + path + "' has a corrupted frame index";
+            Close();
+            return false;
+        }
+    }
+
+    m_index = index;
+    m_numFrames = footer.numFrames;
+    m_decoded.resize(m_header.numParticles);
+    return true;
+}
+
+void FrameCacheReader::DecodeDelta(int frame)
+{
+    int keyframe = frame;
+    while(!(m_index[keyframe].flags & FRAME_CACHE_KEYFRAME))
+    {
+        keyframe--;
+    }
+
+    const int n = m_header.numParticles;
+    int first = keyframe;
+    if(m_decodedFrame >= keyframe && m_decodedFrame <= frame)
+    {
+        first = m_decodedFrame + 1;
+    }
+
+    for(int f = first; f <= frame; f++)
+    {
+        dequantizeFrame(m_file.data() + m_index[f].offset, n, f != keyframe,
+                        m_decoded.x.data(), m_decoded.y.data(), m_decoded.z.data());
+    }
+    m_decodedFrame = frame;
+}
+
+void FrameCacheReader::DecodeFrame(int frame, float* xyz)
+{
+    const int n = m_header.numParticles;
+    const unsigned char* data = m_file.data() + m_index[frame].offset;
+    const float* x;
+    const float* y;
+    const float* z;
+
+    if(m_header.encoding == FRAME_CACHE_RAW)
+    {
+        x = reinterpret_cast<const float*>(data);
+        y = x + n;
+        z = y + n;
+    }
+    else
+    {
+        if(m_header.encoding == FRAME_CACHE_QUANTIZED_DELTA)
+        {
+            DecodeDelta(frame);
+        }
+        else
+        {
+            dequantizeFrame(data, n, false, m_decoded.x.data(), m_decoded.y.data(), m_decoded.z.data());
+        }
+        x = m_decoded.x.data();
+        y = m_decoded.y.data();
+        z = m_decoded.z.data();
+    }
+
+    for(int i = 0; i < n; i++)
+    {
+        xyz[3 * i + 0] = x[i];
+        xyz[3 * i + 1] = y[i];
+        xyz[3 * i + 2] = z[i];
+    }
+}
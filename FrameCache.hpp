@@ -0,0 +1,182 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ClothSimulationSystem.hpp"
+#include "MappedFile.hpp"
+#include "ParticleBuffer.hpp"
+
+// Frame cache file (.clothcache), little-endian:
+//
+//   FrameCacheHeader
+//   frames                 one record per frame, each starting on a
+//                          FRAME_CACHE_ALIGNMENT byte boundary
+//   index                  numFrames FrameCacheIndexEntry, also aligned
+//   FrameCacheFooter       last bytes of the file
+//
+// A raw frame holds numParticles floats of x, then y, then z. A quantized
+// frame holds a FrameCacheQuantization followed by numParticles uint16 of
+// x, then y, then z, each mapping [0, 65535] linearly onto the frame's
+// bounding box. Delta frames are quantized the same way, but store the
+// offset from the previous decoded frame instead of the position, which
+// keeps the error down to a fraction of how far particles moved.
+
+static const char FRAME_CACHE_MAGIC[8] = { 'C', 'L', 'T', 'H', 'C', 'C', 'H', '\0' };
+static const char FRAME_CACHE_FOOTER_MAGIC[8] = { 'C', 'L', 'T', 'H', 'I', 'D', 'X', '\0' };
+static const uint32_t FRAME_CACHE_VERSION = 1;
+static const uint64_t FRAME_CACHE_ALIGNMENT = 64;
+
+enum FrameCacheEncoding {
+    FRAME_CACHE_RAW = 0,
+    FRAME_CACHE_QUANTIZED = 1,
+    FRAME_CACHE_QUANTIZED_DELTA = 2
+};
+
+// FrameCacheIndexEntry flags
+static const uint32_t FRAME_CACHE_KEYFRAME = 1;
+
+struct FrameCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t numParticles;
+    uint32_t encoding;
+    uint32_t keyframeInterval;
+    uint32_t reserved;
+};
+
+struct FrameCacheQuantization {
+    float min[3];
+    float step[3];
+};
+
+struct FrameCacheIndexEntry {
+    uint64_t offset;
+    uint32_t size;
+    uint32_t flags;
+    double time;
+};
+
+struct FrameCacheFooter {
+    uint64_t indexOffset;
+    uint32_t numFrames;
+    uint32_t reserved;
+    char magic[8];
+};
+
+struct FrameCacheOptions {
+    FrameCacheEncoding encoding = FRAME_CACHE_RAW;
+    // with FRAME_CACHE_QUANTIZED_DELTA, every keyframeInterval-th frame is
+    // stored whole so that seeking never decodes more than that many frames
+    int keyframeInterval = 30;
+    // frames waiting to be written at most, each a full copy of the positions
+    int maxQueuedFrames = 64;
+};
+
+// Appends frames to a cache file from a background thread. PushFrame only
+// copies the positions into a recycled buffer, so the simulation doesn't
+// wait on encoding or on the disk, unless it gets maxQueuedFrames ahead of
+// it: PushFrame then blocks until a frame is written, which keeps memory
+// bounded on long bakes, and counts it as a stall.
+class FrameCacheWriter
+{
+
+public:
+
+    FrameCacheWriter();
+    ~FrameCacheWriter();
+
+    FrameCacheWriter(const FrameCacheWriter&) = delete;
+    FrameCacheWriter& operator= (const FrameCacheWriter&) = delete;
+
+    bool Open(const std::string& path, int numParticles, const FrameCacheOptions& options,
+              std::string& error);
+    void PushFrame(const ClothSimulationSystem& system, double time);
+    // Waits for every pushed frame to be written, then writes the index.
+    bool Close(std::string& error);
+
+    bool isOpen() const { return m_open; }
+    int getNumFrames() const { return m_numFrames; }
+    // PushFrame calls that had to wait for the I/O thread since Open().
+    int getNumStalls() const { return m_numStalls; }
+
+private:
+
+    struct PendingFrame {
+        ParticleBuffer pos;
+        double time;
+    };
+
+    std::ofstream m_file;
+    std::string m_path;
+    bool m_open;
+    int m_numParticles;
+    int m_numFrames;
+    int m_numStalls;
+    FrameCacheOptions m_options;
+
+    // only touched by the I/O thread
+    std::vector<FrameCacheIndexEntry> m_index;
+    ParticleBuffer m_decoded;
+    std::vector<uint16_t> m_quantized;
+    bool m_writeFailed;
+
+    std::thread m_ioThread;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp, m_frameWritten;
+    std::deque<PendingFrame> m_queue;
+    std::vector<PendingFrame> m_freeFrames;
+    bool m_closing;
+
+    void IoLoop();
+    void WriteFrame(const PendingFrame& frame);
+};
+
+// Memory-mapped frame cache. Raw and quantized frames are decoded on their
+// own, so seeking costs the same wherever the frame is; delta frames are
+// decoded from the closest keyframe, or from the last decoded frame when
+// playing forward.
+class FrameCacheReader
+{
+
+public:
+
+    FrameCacheReader();
+
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+
+    bool isOpen() const { return m_index != nullptr; }
+    int getNumFrames() const { return m_numFrames; }
+    int getNumParticles() const { return m_header.numParticles; }
+    double getFrameTime(int frame) const { return m_index[frame].time; }
+
+    // Writes interleaved x, y, z positions of frame into a buffer of
+    // 3 * getNumParticles() floats.
+    void DecodeFrame(int frame, float* xyz);
+
+private:
+
+    MappedFile m_file;
+    FrameCacheHeader m_header;
+    const FrameCacheIndexEntry* m_index;
+    int m_numFrames;
+
+    // last delta frame decoded, in full
+    ParticleBuffer m_decoded;
+    int m_decodedFrame;
+
+    void DecodeDelta(int frame);
+};
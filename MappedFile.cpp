@@ -0,0 +1,66 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MappedFile.hpp"
+
+MappedFile::MappedFile()
+{
+    m_data = nullptr;
+    m_size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path, std::string& error)
+{
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        error = "can't open '" + path + "'";
+        return false;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        error = "'" + path + "' is empty or unreadable";
+        return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file alive
+
+    if(data == MAP_FAILED)
+    {
+        error = "can't map '" + path + "'";
+        return false;
+    }
+
+    m_data = static_cast<unsigned char*>(data);
+    m_size = info.st_size;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if(m_data)
+    {
+        munmap(m_data, m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+}
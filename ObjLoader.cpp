@@ -0,0 +1,75 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+
+#include "ObjLoader.hpp"
+
+bool loadObj(const std::string& path, std::vector<Vec3f>& vertices,
+             std::vector<int>& triangles, std::string& error)
+{
+    std::ifstream file(path.c_str());
+    if(!file)
+    {
+        error = "can't open '" + path + "'";
+        return false;
+    }
+
+    vertices.clear();
+    triangles.clear();
+
+    std::string line;
+    std::vector<int> face;
+    int lineNumber = 0;
+
+    while(std::getline(file, line))
+    {
+        lineNumber++;
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+
+        if(keyword == "v")
+        {
+            float x, y, z;
+            if(!(stream >> x >> y >> z))
+            {
+                error = "bad vertex on line " + std::to_string(lineNumber);
+                return false;
+            }
+            vertices.push_back(Vec3f(x, y, z));
+        }
+        else if(keyword == "f")
+        {
+            // each corner is "v", "v/vt", "v//vn" or "v/vt/vn"; only v matters,
+            // and negative indices count back from the last vertex read
+            face.clear();
+            std::string corner;
+            while(stream >> corner)
+            {
+                long idx = strtol(corner.c_str(), nullptr, 10);
+                idx = idx < 0 ? static_cast<long>(vertices.size()) + idx : idx - 1;
+
+                if(idx < 0 || idx >= static_cast<long>(vertices.size()))
+                {
+                    error = "bad face index on line " + std::to_string(lineNumber);
+                    return false;
+                }
+                face.push_back(static_cast<int>(idx));
+            }
+
+            for(unsigned int k = 2; k < face.size(); k++)
+            {
+                triangles.push_back(face[0]);
+                triangles.push_back(face[k - 1]);
+                triangles.push_back(face[k]);
+            }
+        }
+    }
+
+    return true;
+}
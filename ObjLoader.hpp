@@ -0,0 +1,18 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Vec3.hpp"
+
+// Reads the vertices and faces of a Wavefront OBJ file. Faces with more than
+// 3 vertices are split into triangles (as a fan), and everything other than
+// "v" and "f" lines is ignored. triangles holds 3 vertex indices (from 0) per
+// triangle. Returns false and fills error if the file can't be used.
+bool loadObj(const std::string& path, std::vector<Vec3f>& vertices,
+             std::vector<int>& triangles, std::string& error);
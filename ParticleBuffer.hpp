@@ -0,0 +1,24 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "AlignedAllocator.hpp"
+
+// Structure-of-arrays storage for one per-particle vector quantity.
+// Keeping x, y and z in separate aligned arrays lets the integrator
+// loops be vectorized instead of working on one Vec3f at a time.
+struct ParticleBuffer {
+    FloatArray x, y, z;
+
+    unsigned int size() const { return x.size(); }
+
+    void resize(unsigned int n)
+    {
+        x.resize(n, 0.0f);
+        y.resize(n, 0.0f);
+        z.resize(n, 0.0f);
+    }
+};
@@ -0,0 +1,159 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+
+#include "ClothSimulationSystem.hpp"
+#include "ParticleOrdering.hpp"
+
+static const char* const orderingNames[] = { "original", "morton", "rcm" };
+
+bool parseParticleOrdering(const std::string& name, ParticleOrdering& ordering)
+{
+    for(unsigned int i = 0; i < sizeof(orderingNames) / sizeof(orderingNames[0]); i++)
+    {
+        if(name == orderingNames[i])
+        {
+            ordering = static_cast<ParticleOrdering>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* getParticleOrderingName(ParticleOrdering ordering)
+{
+    return orderingNames[static_cast<int>(ordering)];
+}
+
+// Spreads the low 21 bits of v out to every third bit.
+static uint64_t spreadBits(uint64_t v)
+{
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x001f00000000ffffull;
+    v = (v | v << 16) & 0x001f0000ff0000ffull;
+    v = (v | v << 8) & 0x100f00f00f00f00full;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+    v = (v | v << 2) & 0x1249249249249249ull;
+    return v;
+}
+
+void computeMortonOrder(const ParticleBuffer& pos, std::vector<int>& order)
+{
+    const int numParticles = pos.size();
+    order.resize(numParticles);
+    if(numParticles == 0)
+    {
+        return;
+    }
+
+    float min[3] = { INFINITY, INFINITY, INFINITY };
+    float max[3] = { -INFINITY, -INFINITY, -INFINITY };
+    const FloatArray* coords[3] = { &pos.x, &pos.y, &pos.z };
+    for(int k = 0; k < 3; k++)
+    {
+        for(int i = 0; i < numParticles; i++)
+        {
+            min[k] = std::min(min[k], (*coords[k])[i]);
+            max[k] = std::max(max[k], (*coords[k])[i]);
+        }
+    }
+
+    // the same scale on every axis, so the curve follows the shape's
+    // proportions, on a grid of 2^21 cells along the longest axis
+    const float extent = std::max(std::max(max[0] - min[0], max[1] - min[1]), max[2] - min[2]);
+    const float scale = extent > 0.0f ? 2097151.0f / extent : 0.0f;
+
+    std::vector<std::pair<uint64_t, int>> keys(numParticles);
+    for(int i = 0; i < numParticles; i++)
+    {
+        uint64_t code = 0;
+        for(int k = 0; k < 3; k++)
+        {
+            uint64_t cell = static_cast<uint64_t>(((*coords[k])[i] - min[k]) * scale);
+            code |= spreadBits(cell) << k;
+        }
+        keys[i] = std::make_pair(code, i);
+    }
+
+    std::sort(keys.begin(), keys.end());
+    for(int i = 0; i < numParticles; i++)
+    {
+        order[i] = keys[i].second;
+    }
+}
+
+void computeReverseCuthillMcKeeOrder(int numParticles, const std::vector<Constraint>& constraints,
+                                     std::vector<int>& order)
+{
+    // symmetric adjacency, as CSR
+    std::vector<int> offsets(numParticles + 1, 0);
+    for(unsigned int i = 0; i < constraints.size(); i++)
+    {
+        offsets[constraints[i].idxA + 1]++;
+        offsets[constraints[i].idxB + 1]++;
+    }
+    for(int i = 0; i < numParticles; i++)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    std::vector<int> neighbors(offsets[numParticles]);
+    for(unsigned int i = 0; i < constraints.size(); i++)
+    {
+        neighbors[fill[constraints[i].idxA]++] = constraints[i].idxB;
+        neighbors[fill[constraints[i].idxB]++] = constraints[i].idxA;
+    }
+
+    auto degree = [&](int i) { return offsets[i + 1] - offsets[i]; };
+    auto byDegree = [&](int a, int b) { return degree(a) != degree(b) ? degree(a) < degree(b) : a < b; };
+
+    // each connected component is walked breadth-first from its particle of
+    // lowest degree (a cheap stand-in for a peripheral one), visiting the
+    // neighbors of a particle by increasing degree
+    std::vector<int> starts(numParticles);
+    for(int i = 0; i < numParticles; i++)
+    {
+        starts[i] = i;
+    }
+    std::sort(starts.begin(), starts.end(), byDegree);
+
+    std::vector<bool> visited(numParticles, false);
+    order.clear();
+    order.reserve(numParticles);
+
+    for(int s = 0; s < numParticles; s++)
+    {
+        if(visited[starts[s]])
+        {
+            continue;
+        }
+
+        unsigned int head = order.size();
+        order.push_back(starts[s]);
+        visited[starts[s]] = true;
+
+        while(head < order.size())
+        {
+            int particle = order[head++];
+            unsigned int first = order.size();
+
+            for(int k = offsets[particle]; k < offsets[particle + 1]; k++)
+            {
+                if(!visited[neighbors[k]])
+                {
+                    visited[neighbors[k]] = true;
+                    order.push_back(neighbors[k]);
+                }
+            }
+            std::sort(order.begin() + first, order.end(), byDegree);
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+}
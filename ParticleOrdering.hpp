@@ -0,0 +1,33 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ParticleBuffer.hpp"
+
+struct Constraint;
+
+// Particle numberings that keep particles that are solved together close
+// in memory, instead of in whatever order a loader created them.
+enum class ParticleOrdering {
+    Original,           // as given
+    Morton,             // along a Z-order curve through the positions
+    ReverseCuthillMcKee // breadth-first through the constraint graph, reversed
+};
+
+// Command-line names of the orderings ("original", "morton", "rcm").
+// parseParticleOrdering returns false for an unknown name.
+bool parseParticleOrdering(const std::string& name, ParticleOrdering& ordering);
+const char* getParticleOrderingName(ParticleOrdering ordering);
+
+// Both fill order with a permutation of the particles: order[i] is the
+// particle that comes i-th. Ties are broken by index, so the result only
+// depends on the input.
+void computeMortonOrder(const ParticleBuffer& pos, std::vector<int>& order);
+void computeReverseCuthillMcKeeOrder(int numParticles, const std::vector<Constraint>& constraints,
+                                     std::vector<int>& order);
@@ -0,0 +1,241 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+#include "Profiler.hpp"
+
+// Samples kept per thread.
+static const unsigned int profileWindowSize = 1 << 16;
+
+struct ProfileSample {
+    int64_t startNs, endNs;
+    int section;
+};
+
+// Samples of one thread. Only that thread writes them, the mutex is there
+// for the reports, so it is hardly ever contended.
+struct ThreadProfile {
+    std::mutex mutex;
+    std::vector<ProfileSample> samples;
+    uint64_t numRecorded = 0;
+    int threadIdx = 0;
+};
+
+// Section names and thread buffers; buffers outlive their thread so that
+// a report still sees what a finished thread recorded.
+struct ProfileRegistry {
+    std::mutex mutex;
+    std::vector<std::string> sectionNames;
+    std::vector<std::shared_ptr<ThreadProfile>> threads;
+};
+
+static ProfileRegistry& getRegistry()
+{
+    static ProfileRegistry registry;
+    return registry;
+}
+
+static ThreadProfile& getThreadProfile()
+{
+    static thread_local std::shared_ptr<ThreadProfile> t_profile;
+    if(!t_profile)
+    {
+        ProfileRegistry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        t_profile = std::make_shared<ThreadProfile>();
+        t_profile->threadIdx = registry.threads.size();
+        t_profile->samples.reserve(profileWindowSize);
+        registry.threads.push_back(t_profile);
+    }
+    return *t_profile;
+}
+
+int registerProfileSection(const char* name)
+{
+    ProfileRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for(unsigned int i = 0; i < registry.sectionNames.size(); i++)
+    {
+        if(registry.sectionNames[i] == name)
+        {
+            return i;
+        }
+    }
+    registry.sectionNames.push_back(name);
+    return registry.sectionNames.size() - 1;
+}
+
+void recordProfileSample(int section, int64_t startNs, int64_t endNs)
+{
+    ThreadProfile& profile = getThreadProfile();
+    std::lock_guard<std::mutex> lock(profile.mutex);
+
+    ProfileSample sample = { startNs, endNs, section };
+    if(profile.samples.size() < profileWindowSize)
+    {
+        profile.samples.push_back(sample);
+    }
+    else
+    {
+        profile.samples[profile.numRecorded % profileWindowSize] = sample;
+    }
+    profile.numRecorded++;
+}
+
+// Copy of every thread's samples, with the index of the thread they come from.
+static void collectSamples(std::vector<std::pair<int, ProfileSample>>& samples,
+                           std::vector<std::string>& sectionNames)
+{
+    ProfileRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    sectionNames = registry.sectionNames;
+    samples.clear();
+    for(unsigned int t = 0; t < registry.threads.size(); t++)
+    {
+        ThreadProfile& profile = *registry.threads[t];
+        std::lock_guard<std::mutex> threadLock(profile.mutex);
+        for(unsigned int i = 0; i < profile.samples.size(); i++)
+        {
+            samples.push_back(std::make_pair(profile.threadIdx, profile.samples[i]));
+        }
+    }
+}
+
+static double percentile(std::vector<double>& values, double fraction)
+{
+    size_t k = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+void getProfileStats(std::vector<ProfileSectionStats>& stats)
+{
+    std::vector<std::pair<int, ProfileSample>> samples;
+    std::vector<std::string> sectionNames;
+    collectSamples(samples, sectionNames);
+
+    std::vector<std::vector<double>> durations(sectionNames.size());
+    for(unsigned int i = 0; i < samples.size(); i++)
+    {
+        const ProfileSample& sample = samples[i].second;
+        durations[sample.section].push_back(static_cast<double>(sample.endNs - sample.startNs));
+    }
+
+    stats.clear();
+    for(unsigned int s = 0; s < sectionNames.size(); s++)
+    {
+        std::vector<double>& values = durations[s];
+        if(values.empty())
+        {
+            continue;
+        }
+
+        ProfileSectionStats section;
+        section.name = sectionNames[s];
+        section.count = values.size();
+        for(unsigned int i = 0; i < values.size(); i++)
+        {
+            section.totalNs += values[i];
+            section.maxNs = std::max(section.maxNs, values[i]);
+        }
+        section.p50Ns = percentile(values, 0.5);
+        section.p99Ns = percentile(values, 0.99);
+        stats.push_back(section);
+    }
+}
+
+void printProfileReport(std::ostream& out)
+{
+    if(!isProfilingEnabled())
+    {
+        out << "Profiling is disabled, build with CXXFLAGS=-DCLOTH_ENABLE_PROFILING." << std::endl;
+        return;
+    }
+
+    std::vector<ProfileSectionStats> stats;
+    getProfileStats(stats);
+
+    std::ios::fmtflags flags = out.flags();
+    out << std::left << std::setw(24) << "section" << std::right
+        << std::setw(10) << "count" << std::setw(12) << "mean us"
+        << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "max us" << std::endl;
+    out << std::fixed << std::setprecision(2);
+    for(unsigned int i = 0; i < stats.size(); i++)
+    {
+        const ProfileSectionStats& section = stats[i];
+        out << std::left << std::setw(24) << section.name << std::right
+            << std::setw(10) << section.count
+            << std::setw(12) << section.totalNs / section.count * 1.0e-3
+            << std::setw(12) << section.p50Ns * 1.0e-3
+            << std::setw(12) << section.p99Ns * 1.0e-3
+            << std::setw(12) << section.maxNs * 1.0e-3 << std::endl;
+    }
+    out.flags(flags);
+}
+
+bool writeChromeTrace(const std::string& path, std::string& error)
+{
+    std::vector<std::pair<int, ProfileSample>> samples;
+    std::vector<std::string> sectionNames;
+    collectSamples(samples, sectionNames);
+
+    int64_t originNs = 0;
+    for(unsigned int i = 0; i < samples.size(); i++)
+    {
+        if(i == 0 || samples[i].second.startNs < originNs)
+        {
+            originNs = samples[i].second.startNs;
+        }
+    }
+
+    std::ofstream file(path.c_str());
+    if(!file)
+    {
+        error = "can't open '" + path + "' for writing";
+        return false;
+    }
+
+    // timestamps in microseconds, from the oldest sample
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for(unsigned int i = 0; i < samples.size(); i++)
+    {
+        const ProfileSample& sample = samples[i].second;
+        file << (i == 0 ? "\n" : ",\n")
+             << "{\"name\":\"" << sectionNames[sample.section] << "\",\"ph\":\"X\""
+             << ",\"ts\":" << (sample.startNs - originNs) * 1.0e-3
+             << ",\"dur\":" << (sample.endNs - sample.startNs) * 1.0e-3
+             << ",\"pid\":0,\"tid\":" << samples[i].first << "}";
+    }
+    file << "\n]}\n";
+
+    if(!file)
+    {
+        error = "error while writing '" + path + "'";
+        return false;
+    }
+    return true;
+}
+
+void resetProfile()
+{
+    ProfileRegistry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for(unsigned int t = 0; t < registry.threads.size(); t++)
+    {
+        ThreadProfile& profile = *registry.threads[t];
+        std::lock_guard<std::mutex> threadLock(profile.mutex);
+        profile.samples.clear();
+        profile.numRecorded = 0;
+    }
+}
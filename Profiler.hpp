@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Scoped timers around the hot phases of the simulation and the viewer.
+// CLOTH_PROFILE_SCOPE("name") times the rest of the enclosing block; it
+// compiles to nothing unless CLOTH_ENABLE_PROFILING is defined, e.g. with
+//
+//     CXXFLAGS=-DCLOTH_ENABLE_PROFILING sh generate
+//
+// Each thread keeps its last 65536 samples in a ring buffer, which the
+// statistics and the Chrome trace are computed from, so they always cover
+// a recent, bounded window of the run.
+
+#ifdef CLOTH_ENABLE_PROFILING
+#define CLOTH_PROFILE_CONCAT_(a, b) a##b
+#define CLOTH_PROFILE_CONCAT(a, b) CLOTH_PROFILE_CONCAT_(a, b)
+#define CLOTH_PROFILE_SCOPE(name) \
+    static const int CLOTH_PROFILE_CONCAT(profileSection, __LINE__) = registerProfileSection(name); \
+    ProfileScope CLOTH_PROFILE_CONCAT(profileScope, __LINE__)(CLOTH_PROFILE_CONCAT(profileSection, __LINE__))
+#else
+#define CLOTH_PROFILE_SCOPE(name) do {} while(0)
+#endif
+
+inline bool isProfilingEnabled()
+{
+#ifdef CLOTH_ENABLE_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline int64_t profileClockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Id of the section called name, the same for every call with that name.
+int registerProfileSection(const char* name);
+void recordProfileSample(int section, int64_t startNs, int64_t endNs);
+
+class ProfileScope
+{
+
+public:
+
+    explicit ProfileScope(int section) : m_section(section), m_startNs(profileClockNs()) {}
+    ~ProfileScope() { recordProfileSample(m_section, m_startNs, profileClockNs()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+
+    int m_section;
+    int64_t m_startNs;
+};
+
+struct ProfileSectionStats {
+    std::string name;
+    int count = 0;
+    double totalNs = 0.0;
+    double p50Ns = 0.0, p99Ns = 0.0, maxNs = 0.0;
+};
+
+// Statistics of every section with samples in the window, in the order
+// sections were first entered.
+void getProfileStats(std::vector<ProfileSectionStats>& stats);
+// Table of getProfileStats, in microseconds.
+void printProfileReport(std::ostream& out);
+// The samples of the window as complete ("X") events of the Chrome trace
+// format, to open in chrome://tracing or Perfetto. Returns false and sets
+// error if the file can't be written.
+bool writeChromeTrace(const std::string& path, std::string& error);
+void resetProfile();
@@ -0,0 +1,200 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+#include <fstream>
+
+#include "MappedFile.hpp"
+#include "SceneFile.hpp"
+
+static_assert(sizeof(Constraint) == 16, "Constraint is stored as is in scene files");
+static_assert(sizeof(SceneFileHeader) == 72, "SceneFileHeader must not have padding");
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "scene files are little-endian and are read without byte swapping"
+#endif
+
+// Constraint of version 1 files, before compliances.
+struct SceneFileConstraintV1 {
+    int idxA, idxB;
+    float restlength;
+};
+static_assert(sizeof(SceneFileConstraintV1) == 12, "version 1 constraints are 12 bytes");
+
+static uint64_t align(uint64_t offset)
+{
+    return (offset + SCENE_FILE_ALIGNMENT - 1) / SCENE_FILE_ALIGNMENT * SCENE_FILE_ALIGNMENT;
+}
+
+static void writeSection(std::ofstream& file, uint64_t offset, const void* data, uint64_t size)
+{
+    static const char padding[SCENE_FILE_ALIGNMENT] = { 0 };
+
+    uint64_t position = static_cast<uint64_t>(file.tellp());
+    file.write(padding, offset - position);
+    file.write(static_cast<const char*>(data), size);
+}
+
+static bool writeSceneFile(const std::string& path, uint32_t numParticles,
+                           const float* x, const float* y, const float* z,
+                           const float* invMass, uint32_t numConstraints,
+                           const Constraint* constraints, std::string& error)
+{
+    const uint64_t floatsSize = numParticles * sizeof(float);
+
+    SceneFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic));
+    header.version = SCENE_FILE_VERSION;
+    header.headerSize = sizeof(SceneFileHeader);
+    header.numParticles = numParticles;
+    header.numConstraints = numConstraints;
+    header.posXOffset = align(sizeof(SceneFileHeader));
+    header.posYOffset = align(header.posXOffset + floatsSize);
+    header.posZOffset = align(header.posYOffset + floatsSize);
+    header.invMassOffset = align(header.posZOffset + floatsSize);
+    header.constraintsOffset = align(header.invMassOffset + floatsSize);
+    header.fileSize = header.constraintsOffset + numConstraints * sizeof(Constraint);
+
+    std::ofstream file(path.c_str(), std::ios::binary);
+    if(!file)
+    {
+        error = "can't open '" + path + "' for writing";
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeSection(file, header.posXOffset, x, floatsSize);
+    writeSection(file, header.posYOffset, y, floatsSize);
+    writeSection(file, header.posZOffset, z, floatsSize);
+    writeSection(file, header.invMassOffset, invMass, floatsSize);
+    writeSection(file, header.constraintsOffset, constraints, numConstraints * sizeof(Constraint));
+
+    if(!file)
+    {
+        error = "error while writing '" + path + "'";
+        return false;
+    }
+    return true;
+}
+
+bool saveSceneFile(const std::string& path, const ClothSimulationSystem& system,
+                   std::string& error)
+{
+    PositionsView pos = system.getPositionsView();
+    ArrayView<Constraint> constraints = system.getConstraintsView();
+
+    return writeSceneFile(path, pos.x.size(), pos.x.data(), pos.y.data(), pos.z.data(),
+                          system.getInvMassView().data(), constraints.size(),
+                          constraints.data(), error);
+}
+
+bool saveSceneFile(const std::string& path, const ParticleBuffer& pos,
+                   const FloatArray& invMass, const std::vector<Constraint>& constraints,
+                   std::string& error)
+{
+    return writeSceneFile(path, pos.size(), pos.x.data(), pos.y.data(), pos.z.data(),
+                          invMass.data(), constraints.size(), constraints.data(), error);
+}
+
+static bool sectionFits(const MappedFile& file, uint64_t offset, uint64_t size)
+{
+    return offset % sizeof(float) == 0 && offset <= file.size() && size <= file.size() - offset;
+}
+
+bool loadSceneFile(const std::string& path, ClothSimulationSystem& system,
+                   std::string& error)
+{
+    MappedFile file;
+    if(!file.Open(path, error))
+    {
+        return false;
+    }
+
+    SceneFileHeader header;
+    if(file.size() < sizeof(header))
+    {
+        error = "'" + path + "' is too small to be a scene file";
+        return false;
+    }
+    memcpy(&header, file.data(), sizeof(header));
+
+    if(memcmp(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        error = "'" + path + "' is not a scene file";
+        return false;
+    }
+    if((header.version != 1 && header.version != SCENE_FILE_VERSION) ||
+       header.headerSize != sizeof(SceneFileHeader))
+    {
+        error = "'" + path + "' has unsupported version " + std::to_string(header.version);
+        return false;
+    }
+
+    const uint64_t floatsSize = header.numParticles * static_cast<uint64_t>(sizeof(float));
+    const uint64_t constraintSize = header.version == 1 ? sizeof(SceneFileConstraintV1) : sizeof(Constraint);
+    const uint64_t constraintsSize = header.numConstraints * constraintSize;
+
+    if(!sectionFits(file, header.posXOffset, floatsSize) ||
+       !sectionFits(file, header.posYOffset, floatsSize) ||
+       !sectionFits(file, header.posZOffset, floatsSize) ||
+       !sectionFits(file, header.invMassOffset, floatsSize) ||
+       !sectionFits(file, header.constraintsOffset, constraintsSize))
+    {
+        error = "'" + path + "' is truncated or corrupted";
+        return false;
+    }
+
+    const unsigned char* data = file.data();
+    const float* x = reinterpret_cast<const float*>(data + header.posXOffset);
+    const float* y = reinterpret_cast<const float*>(data + header.posYOffset);
+    const float* z = reinterpret_cast<const float*>(data + header.posZOffset);
+    const float* invMass = reinterpret_cast<const float*>(data + header.invMassOffset);
+    const unsigned char* constraints = data + header.constraintsOffset;
+
+    std::vector<Constraint> constraintList(header.numConstraints);
+    if(header.version == 1)
+    {
+        for(uint32_t i = 0; i < header.numConstraints; i++)
+        {
+            SceneFileConstraintV1 c;
+            memcpy(&c, constraints + i * sizeof(c), sizeof(c));
+            constraintList[i].idxA = c.idxA;
+            constraintList[i].idxB = c.idxB;
+            constraintList[i].restlength = c.restlength;
+        }
+    }
+    else if(header.numConstraints > 0)
+    {
+        memcpy(constraintList.data(), constraints, constraintsSize);
+    }
+
+    // indices are the only thing that could make the simulation read out of bounds
+    const int numParticles = header.numParticles;
+    for(uint32_t i = 0; i < header.numConstraints; i++)
+    {
+        if(constraintList[i].idxA < 0 || constraintList[i].idxA >= numParticles ||
+           constraintList[i].idxB < 0 || constraintList[i].idxB >= numParticles)
+        {
+            error = "'" + path + "' has a constraint on a particle that doesn't exist";
+            return false;
+        }
+        // negative compliances would make the XPBD solver divide by zero
+        if(!(constraintList[i].compliance >= 0.0f))
+        {
+            error = "'" + path + "' has a constraint with a negative or invalid compliance";
+            return false;
+        }
+    }
+
+    ParticleBuffer pos;
+    pos.x.assign(x, x + numParticles);
+    pos.y.assign(y, y + numParticles);
+    pos.z.assign(z, z + numParticles);
+
+    FloatArray masses(invMass, invMass + numParticles);
+
+    system = ClothSimulationSystem(std::move(pos), std::move(masses), std::move(constraintList));
+    return true;
+}
@@ -0,0 +1,51 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include "ClothSimulationSystem.hpp"
+
+// Binary scene file (.cloth). Everything is little-endian and laid out the
+// way ClothSimulationSystem stores it, so loading is a handful of bulk
+// copies out of a memory-mapped file:
+//
+//   SceneFileHeader
+//   x, y and z positions   numParticles floats each
+//   inverse masses         numParticles floats, 0 for pinned particles
+//   constraints            numConstraints Constraint structs
+//
+// Every section starts on a SCENE_FILE_ALIGNMENT byte boundary. Version 1
+// files, whose constraints have no compliance, are still read; their
+// constraints get a compliance of 0.
+
+static const char SCENE_FILE_MAGIC[8] = { 'C', 'L', 'T', 'H', 'S', 'C', 'N', '\0' };
+static const uint32_t SCENE_FILE_VERSION = 2;
+static const uint64_t SCENE_FILE_ALIGNMENT = 64;
+
+struct SceneFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t numParticles;
+    uint32_t numConstraints;
+    uint64_t posXOffset, posYOffset, posZOffset;
+    uint64_t invMassOffset;
+    uint64_t constraintsOffset;
+    uint64_t fileSize;
+};
+
+// Writes the current positions, inverse masses and constraints of system.
+bool saveSceneFile(const std::string& path, const ClothSimulationSystem& system,
+                   std::string& error);
+
+bool saveSceneFile(const std::string& path, const ParticleBuffer& pos,
+                   const FloatArray& invMass, const std::vector<Constraint>& constraints,
+                   std::string& error);
+
+bool loadSceneFile(const std::string& path, ClothSimulationSystem& system,
+                   std::string& error);
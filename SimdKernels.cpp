@@ -0,0 +1,632 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SimdKernels.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CLOTH_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+//---------------------------------------------------------------------------------------
+// Scalar fallback, also used for the tail of the vectorized kernels
+//---------------------------------------------------------------------------------------
+
+static void accumulateForcesScalar(ParticleBuffer& pos, ParticleBuffer& forces,
+                                   const float* invMass, float stepSize,
+                                   int begin, int end)
+{
+    float* __restrict px = pos.x.data();
+    float* __restrict py = pos.y.data();
+    float* __restrict pz = pos.z.data();
+    float* __restrict fx = forces.x.data();
+    float* __restrict fy = forces.y.data();
+    float* __restrict fz = forces.z.data();
+
+    for(int i = begin; i < end; i++)
+    {
+        float movable = invMass[i] > 0.0f ? 1.0f : 0.0f;
+
+        px[i] += fx[i] * stepSize * movable;
+        py[i] += fy[i] * stepSize * movable;
+        pz[i] += fz[i] * stepSize * movable;
+
+        // force has been applied
+        fx[i] = movable > 0.0f ? 0.0f : fx[i];
+        fy[i] = movable > 0.0f ? 0.0f : fy[i];
+        fz[i] = movable > 0.0f ? 0.0f : fz[i];
+    }
+}
+
+static void verletScalar(ParticleBuffer& pos, ParticleBuffer& oldPos,
+                         const ParticleBuffer& forces, const float* invMass,
+                         float stepSize, int begin, int end)
+{
+    const float stepSizeSq = stepSize * stepSize;
+    float* __restrict px = pos.x.data();
+    float* __restrict py = pos.y.data();
+    float* __restrict pz = pos.z.data();
+    float* __restrict ox = oldPos.x.data();
+    float* __restrict oy = oldPos.y.data();
+    float* __restrict oz = oldPos.z.data();
+    const float* __restrict fx = forces.x.data();
+    const float* __restrict fy = forces.y.data();
+    const float* __restrict fz = forces.z.data();
+
+    for(int i = begin; i < end; i++)
+    {
+        bool movable = invMass[i] > 0.0f;
+        float accel = stepSizeSq * invMass[i];
+
+        float x = px[i], y = py[i], z = pz[i];
+
+        px[i] = movable ? (x + x) - ox[i] + fx[i] * accel : x;
+        py[i] = movable ? (y + y) - oy[i] + fy[i] * accel : y;
+        pz[i] = movable ? (z + z) - oz[i] + fz[i] * accel : z;
+
+        ox[i] = movable ? x : ox[i];
+        oy[i] = movable ? y : oy[i];
+        oz[i] = movable ? z : oz[i];
+    }
+}
+
+// The collider projections are written so that every level does the same
+// operations in the same order: no reciprocal estimates, no fused
+// multiply-adds, and selects instead of branches.
+
+static inline void projectPlane(float& x, float& y, float& z, const PlaneCollider& plane)
+{
+    float distance = plane.normal[0] * x + plane.normal[1] * y + plane.normal[2] * z - plane.offset;
+    float penetration = distance < 0.0f ? distance : 0.0f;
+
+    x -= plane.normal[0] * penetration;
+    y -= plane.normal[1] * penetration;
+    z -= plane.normal[2] * penetration;
+}
+
+static inline void projectSphere(float& x, float& y, float& z,
+                                 float cx, float cy, float cz, float radius)
+{
+    float dx = x - cx, dy = y - cy, dz = z - cz;
+    float distanceSq = dx * dx + dy * dy + dz * dz;
+    bool inside = distanceSq < radius * radius && distanceSq > 0.0f;
+    float scale = radius / sqrtf(distanceSq);
+
+    x = inside ? cx + dx * scale : x;
+    y = inside ? cy + dy * scale : y;
+    z = inside ? cz + dz * scale : z;
+}
+
+static inline void projectCapsule(float& x, float& y, float& z, const CapsuleCollider& capsule,
+                                  float abx, float aby, float abz, float invLengthSq)
+{
+    const Vec3f& a = capsule.a;
+    float t = ((x - a[0]) * abx + (y - a[1]) * aby + (z - a[2]) * abz) * invLengthSq;
+    t = t > 0.0f ? t : 0.0f;
+    t = t < 1.0f ? t : 1.0f;
+
+    projectSphere(x, y, z, a[0] + abx * t, a[1] + aby * t, a[2] + abz * t, capsule.radius);
+}
+
+static inline void capsuleAxis(const CapsuleCollider& capsule,
+                               float& abx, float& aby, float& abz, float& invLengthSq)
+{
+    abx = capsule.b[0] - capsule.a[0];
+    aby = capsule.b[1] - capsule.a[1];
+    abz = capsule.b[2] - capsule.a[2];
+    float lengthSq = abx * abx + aby * aby + abz * abz;
+    invLengthSq = lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f;
+}
+
+static inline void projectBox(float& x, float& y, float& z, const BoxCollider& box)
+{
+    float dx = x - box.center[0], dy = y - box.center[1], dz = z - box.center[2];
+    float local[3], penetration[3];
+    for(int k = 0; k < 3; k++)
+    {
+        local[k] = dx * box.axes[k][0] + dy * box.axes[k][1] + dz * box.axes[k][2];
+        penetration[k] = box.halfExtents[k] - fabsf(local[k]);
+    }
+
+    // out through the face the particle is closest to
+    bool inside = penetration[0] > 0.0f && penetration[1] > 0.0f && penetration[2] > 0.0f;
+    bool useX = penetration[0] <= penetration[1] && penetration[0] <= penetration[2];
+    bool useY = !useX && penetration[1] <= penetration[2];
+    int axis = useX ? 0 : (useY ? 1 : 2);
+    float push = copysignf(penetration[axis], local[axis]);
+
+    x = inside ? x + box.axes[axis][0] * push : x;
+    y = inside ? y + box.axes[axis][1] * push : y;
+    z = inside ? z + box.axes[axis][2] * push : z;
+}
+
+static void projectCollidersScalar(ParticleBuffer& pos, const float* invMass,
+                                   const ColliderSet& colliders, int begin, int end)
+{
+    float* __restrict px = pos.x.data();
+    float* __restrict py = pos.y.data();
+    float* __restrict pz = pos.z.data();
+
+    for(int i = begin; i < end; i++)
+    {
+        float x = px[i], y = py[i], z = pz[i];
+
+        for(const PlaneCollider& plane : colliders.planes)
+        {
+            projectPlane(x, y, z, plane);
+        }
+        for(const SphereCollider& sphere : colliders.spheres)
+        {
+            projectSphere(x, y, z, sphere.center[0], sphere.center[1], sphere.center[2], sphere.radius);
+        }
+        for(const CapsuleCollider& capsule : colliders.capsules)
+        {
+            float abx, aby, abz, invLengthSq;
+            capsuleAxis(capsule, abx, aby, abz, invLengthSq);
+            projectCapsule(x, y, z, capsule, abx, aby, abz, invLengthSq);
+        }
+        for(const BoxCollider& box : colliders.boxes)
+        {
+            projectBox(x, y, z, box);
+        }
+
+        bool movable = invMass[i] > 0.0f;
+        px[i] = movable ? x : px[i];
+        py[i] = movable ? y : py[i];
+        pz[i] = movable ? z : pz[i];
+    }
+}
+
+#ifdef CLOTH_SIMD_X86
+
+//---------------------------------------------------------------------------------------
+// SSE4.1: 4 particles per instruction
+//---------------------------------------------------------------------------------------
+
+__attribute__((target("sse4.1")))
+static inline void accumulateForces4(float* p, float* f, __m128 mask, __m128 step)
+{
+    __m128 vp = _mm_loadu_ps(p);
+    __m128 vf = _mm_loadu_ps(f);
+    vp = _mm_add_ps(vp, _mm_and_ps(mask, _mm_mul_ps(vf, step)));
+    _mm_storeu_ps(p, vp);
+    _mm_storeu_ps(f, _mm_blendv_ps(vf, _mm_setzero_ps(), mask));
+}
+
+__attribute__((target("sse4.1")))
+static void accumulateForcesSse41(ParticleBuffer& pos, ParticleBuffer& forces,
+                                  const float* invMass, float stepSize,
+                                  int begin, int end)
+{
+    const __m128 step = _mm_set1_ps(stepSize);
+    const __m128 zero = _mm_setzero_ps();
+
+    int i = begin;
+    for(; i + 4 <= end; i += 4)
+    {
+        __m128 mask = _mm_cmpgt_ps(_mm_loadu_ps(invMass + i), zero);
+        accumulateForces4(&pos.x[i], &forces.x[i], mask, step);
+        accumulateForces4(&pos.y[i], &forces.y[i], mask, step);
+        accumulateForces4(&pos.z[i], &forces.z[i], mask, step);
+    }
+
+    accumulateForcesScalar(pos, forces, invMass, stepSize, i, end);
+}
+
+__attribute__((target("sse4.1")))
+static inline void verlet4(float* p, float* o, const float* f, __m128 mask, __m128 accel)
+{
+    __m128 vp = _mm_loadu_ps(p);
+    __m128 vo = _mm_loadu_ps(o);
+    __m128 next = _mm_add_ps(_mm_sub_ps(_mm_add_ps(vp, vp), vo),
+                             _mm_mul_ps(_mm_loadu_ps(f), accel));
+    _mm_storeu_ps(p, _mm_blendv_ps(vp, next, mask));
+    _mm_storeu_ps(o, _mm_blendv_ps(vo, vp, mask));
+}
+
+__attribute__((target("sse4.1")))
+static void verletSse41(ParticleBuffer& pos, ParticleBuffer& oldPos,
+                        const ParticleBuffer& forces, const float* invMass,
+                        float stepSize, int begin, int end)
+{
+    const __m128 stepSizeSq = _mm_set1_ps(stepSize * stepSize);
+    const __m128 zero = _mm_setzero_ps();
+
+    int i = begin;
+    for(; i + 4 <= end; i += 4)
+    {
+        __m128 w = _mm_loadu_ps(invMass + i);
+        __m128 mask = _mm_cmpgt_ps(w, zero);
+        __m128 accel = _mm_mul_ps(stepSizeSq, w);
+        verlet4(&pos.x[i], &oldPos.x[i], &forces.x[i], mask, accel);
+        verlet4(&pos.y[i], &oldPos.y[i], &forces.y[i], mask, accel);
+        verlet4(&pos.z[i], &oldPos.z[i], &forces.z[i], mask, accel);
+    }
+
+    verletScalar(pos, oldPos, forces, invMass, stepSize, i, end);
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128 dot4(__m128 x, __m128 y, __m128 z, float a, float b, float c)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(a)), _mm_mul_ps(y, _mm_set1_ps(b))),
+                      _mm_mul_ps(z, _mm_set1_ps(c)));
+}
+
+__attribute__((target("sse4.1")))
+static inline void projectPlane4(__m128& x, __m128& y, __m128& z, const PlaneCollider& plane)
+{
+    const Vec3f& n = plane.normal;
+    __m128 distance = _mm_sub_ps(dot4(x, y, z, n[0], n[1], n[2]), _mm_set1_ps(plane.offset));
+    __m128 penetration = _mm_min_ps(distance, _mm_setzero_ps());
+
+    x = _mm_sub_ps(x, _mm_mul_ps(_mm_set1_ps(n[0]), penetration));
+    y = _mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(n[1]), penetration));
+    z = _mm_sub_ps(z, _mm_mul_ps(_mm_set1_ps(n[2]), penetration));
+}
+
+__attribute__((target("sse4.1")))
+static inline void projectSphere4(__m128& x, __m128& y, __m128& z,
+                                  __m128 cx, __m128 cy, __m128 cz, float radius)
+{
+    __m128 dx = _mm_sub_ps(x, cx), dy = _mm_sub_ps(y, cy), dz = _mm_sub_ps(z, cz);
+    __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+    __m128 inside = _mm_and_ps(_mm_cmplt_ps(distanceSq, _mm_set1_ps(radius * radius)),
+                               _mm_cmpgt_ps(distanceSq, _mm_setzero_ps()));
+    __m128 scale = _mm_div_ps(_mm_set1_ps(radius), _mm_sqrt_ps(distanceSq));
+
+    x = _mm_blendv_ps(x, _mm_add_ps(cx, _mm_mul_ps(dx, scale)), inside);
+    y = _mm_blendv_ps(y, _mm_add_ps(cy, _mm_mul_ps(dy, scale)), inside);
+    z = _mm_blendv_ps(z, _mm_add_ps(cz, _mm_mul_ps(dz, scale)), inside);
+}
+
+__attribute__((target("sse4.1")))
+static inline void projectCapsule4(__m128& x, __m128& y, __m128& z, const CapsuleCollider& capsule)
+{
+    float abx, aby, abz, invLengthSq;
+    capsuleAxis(capsule, abx, aby, abz, invLengthSq);
+
+    const __m128 ax = _mm_set1_ps(capsule.a[0]);
+    const __m128 ay = _mm_set1_ps(capsule.a[1]);
+    const __m128 az = _mm_set1_ps(capsule.a[2]);
+    __m128 t = _mm_mul_ps(dot4(_mm_sub_ps(x, ax), _mm_sub_ps(y, ay), _mm_sub_ps(z, az), abx, aby, abz),
+                          _mm_set1_ps(invLengthSq));
+    t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+
+    projectSphere4(x, y, z,
+                   _mm_add_ps(ax, _mm_mul_ps(_mm_set1_ps(abx), t)),
+                   _mm_add_ps(ay, _mm_mul_ps(_mm_set1_ps(aby), t)),
+                   _mm_add_ps(az, _mm_mul_ps(_mm_set1_ps(abz), t)), capsule.radius);
+}
+
+__attribute__((target("sse4.1")))
+static inline void projectBox4(__m128& x, __m128& y, __m128& z, const BoxCollider& box)
+{
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    __m128 dx = _mm_sub_ps(x, _mm_set1_ps(box.center[0]));
+    __m128 dy = _mm_sub_ps(y, _mm_set1_ps(box.center[1]));
+    __m128 dz = _mm_sub_ps(z, _mm_set1_ps(box.center[2]));
+
+    __m128 local[3], penetration[3];
+    for(int k = 0; k < 3; k++)
+    {
+        local[k] = dot4(dx, dy, dz, box.axes[k][0], box.axes[k][1], box.axes[k][2]);
+        penetration[k] = _mm_sub_ps(_mm_set1_ps(box.halfExtents[k]), _mm_andnot_ps(signBit, local[k]));
+    }
+
+    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(penetration[0], zero),
+                                          _mm_cmpgt_ps(penetration[1], zero)),
+                               _mm_cmpgt_ps(penetration[2], zero));
+    __m128 useX = _mm_and_ps(_mm_cmple_ps(penetration[0], penetration[1]),
+                             _mm_cmple_ps(penetration[0], penetration[2]));
+    __m128 useY = _mm_andnot_ps(useX, _mm_cmple_ps(penetration[1], penetration[2]));
+
+    __m128 depth = _mm_blendv_ps(_mm_blendv_ps(penetration[2], penetration[1], useY), penetration[0], useX);
+    __m128 side = _mm_blendv_ps(_mm_blendv_ps(local[2], local[1], useY), local[0], useX);
+    __m128 push = _mm_or_ps(_mm_andnot_ps(signBit, depth), _mm_and_ps(signBit, side));
+
+    __m128* coords[3] = { &x, &y, &z };
+    for(int c = 0; c < 3; c++)
+    {
+        __m128 axis = _mm_blendv_ps(_mm_blendv_ps(_mm_set1_ps(box.axes[2][c]),
+                                                  _mm_set1_ps(box.axes[1][c]), useY),
+                                    _mm_set1_ps(box.axes[0][c]), useX);
+        *coords[c] = _mm_blendv_ps(*coords[c], _mm_add_ps(*coords[c], _mm_mul_ps(axis, push)), inside);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void projectCollidersSse41(ParticleBuffer& pos, const float* invMass,
+                                  const ColliderSet& colliders, int begin, int end)
+{
+    const __m128 zero = _mm_setzero_ps();
+
+    int i = begin;
+    for(; i + 4 <= end; i += 4)
+    {
+        const __m128 x0 = _mm_loadu_ps(&pos.x[i]);
+        const __m128 y0 = _mm_loadu_ps(&pos.y[i]);
+        const __m128 z0 = _mm_loadu_ps(&pos.z[i]);
+        __m128 x = x0, y = y0, z = z0;
+
+        for(const PlaneCollider& plane : colliders.planes)
+        {
+            projectPlane4(x, y, z, plane);
+        }
+        for(const SphereCollider& sphere : colliders.spheres)
+        {
+            projectSphere4(x, y, z, _mm_set1_ps(sphere.center[0]), _mm_set1_ps(sphere.center[1]),
+                           _mm_set1_ps(sphere.center[2]), sphere.radius);
+        }
+        for(const CapsuleCollider& capsule : colliders.capsules)
+        {
+            projectCapsule4(x, y, z, capsule);
+        }
+        for(const BoxCollider& box : colliders.boxes)
+        {
+            projectBox4(x, y, z, box);
+        }
+
+        __m128 mask = _mm_cmpgt_ps(_mm_loadu_ps(invMass + i), zero);
+        _mm_storeu_ps(&pos.x[i], _mm_blendv_ps(x0, x, mask));
+        _mm_storeu_ps(&pos.y[i], _mm_blendv_ps(y0, y, mask));
+        _mm_storeu_ps(&pos.z[i], _mm_blendv_ps(z0, z, mask));
+    }
+
+    projectCollidersScalar(pos, invMass, colliders, i, end);
+}
+
+//---------------------------------------------------------------------------------------
+// AVX2: 8 particles per instruction
+//---------------------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+static inline void accumulateForces8(float* p, float* f, __m256 mask, __m256 step)
+{
+    __m256 vp = _mm256_loadu_ps(p);
+    __m256 vf = _mm256_loadu_ps(f);
+    vp = _mm256_add_ps(vp, _mm256_and_ps(mask, _mm256_mul_ps(vf, step)));
+    _mm256_storeu_ps(p, vp);
+    _mm256_storeu_ps(f, _mm256_blendv_ps(vf, _mm256_setzero_ps(), mask));
+}
+
+__attribute__((target("avx2")))
+static void accumulateForcesAvx2(ParticleBuffer& pos, ParticleBuffer& forces,
+                                 const float* invMass, float stepSize,
+                                 int begin, int end)
+{
+    const __m256 step = _mm256_set1_ps(stepSize);
+    const __m256 zero = _mm256_setzero_ps();
+
+    int i = begin;
+    for(; i + 8 <= end; i += 8)
+    {
+        __m256 mask = _mm256_cmp_ps(_mm256_loadu_ps(invMass + i), zero, _CMP_GT_OQ);
+        accumulateForces8(&pos.x[i], &forces.x[i], mask, step);
+        accumulateForces8(&pos.y[i], &forces.y[i], mask, step);
+        accumulateForces8(&pos.z[i], &forces.z[i], mask, step);
+    }
+
+    accumulateForcesScalar(pos, forces, invMass, stepSize, i, end);
+}
+
+__attribute__((target("avx2")))
+static inline void verlet8(float* p, float* o, const float* f, __m256 mask, __m256 accel)
+{
+    __m256 vp = _mm256_loadu_ps(p);
+    __m256 vo = _mm256_loadu_ps(o);
+    __m256 next = _mm256_add_ps(_mm256_sub_ps(_mm256_add_ps(vp, vp), vo),
+                                _mm256_mul_ps(_mm256_loadu_ps(f), accel));
+    _mm256_storeu_ps(p, _mm256_blendv_ps(vp, next, mask));
+    _mm256_storeu_ps(o, _mm256_blendv_ps(vo, vp, mask));
+}
+
+__attribute__((target("avx2")))
+static void verletAvx2(ParticleBuffer& pos, ParticleBuffer& oldPos,
+                       const ParticleBuffer& forces, const float* invMass,
+                       float stepSize, int begin, int end)
+{
+    const __m256 stepSizeSq = _mm256_set1_ps(stepSize * stepSize);
+    const __m256 zero = _mm256_setzero_ps();
+
+    int i = begin;
+    for(; i + 8 <= end; i += 8)
+    {
+        __m256 w = _mm256_loadu_ps(invMass + i);
+        __m256 mask = _mm256_cmp_ps(w, zero, _CMP_GT_OQ);
+        __m256 accel = _mm256_mul_ps(stepSizeSq, w);
+        verlet8(&pos.x[i], &oldPos.x[i], &forces.x[i], mask, accel);
+        verlet8(&pos.y[i], &oldPos.y[i], &forces.y[i], mask, accel);
+        verlet8(&pos.z[i], &oldPos.z[i], &forces.z[i], mask, accel);
+    }
+
+    verletScalar(pos, oldPos, forces, invMass, stepSize, i, end);
+}
+
+__attribute__((target("avx2")))
+static inline __m256 dot8(__m256 x, __m256 y, __m256 z, float a, float b, float c)
+{
+    return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(a)),
+                                       _mm256_mul_ps(y, _mm256_set1_ps(b))),
+                         _mm256_mul_ps(z, _mm256_set1_ps(c)));
+}
+
+__attribute__((target("avx2")))
+static inline void projectPlane8(__m256& x, __m256& y, __m256& z, const PlaneCollider& plane)
+{
+    const Vec3f& n = plane.normal;
+    __m256 distance = _mm256_sub_ps(dot8(x, y, z, n[0], n[1], n[2]), _mm256_set1_ps(plane.offset));
+    __m256 penetration = _mm256_min_ps(distance, _mm256_setzero_ps());
+
+    x = _mm256_sub_ps(x, _mm256_mul_ps(_mm256_set1_ps(n[0]), penetration));
+    y = _mm256_sub_ps(y, _mm256_mul_ps(_mm256_set1_ps(n[1]), penetration));
+    z = _mm256_sub_ps(z, _mm256_mul_ps(_mm256_set1_ps(n[2]), penetration));
+}
+
+__attribute__((target("avx2")))
+static inline void projectSphere8(__m256& x, __m256& y, __m256& z,
+                                  __m256 cx, __m256 cy, __m256 cz, float radius)
+{
+    __m256 dx = _mm256_sub_ps(x, cx), dy = _mm256_sub_ps(y, cy), dz = _mm256_sub_ps(z, cz);
+    __m256 distanceSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                      _mm256_mul_ps(dz, dz));
+    __m256 inside = _mm256_and_ps(_mm256_cmp_ps(distanceSq, _mm256_set1_ps(radius * radius), _CMP_LT_OQ),
+                                  _mm256_cmp_ps(distanceSq, _mm256_setzero_ps(), _CMP_GT_OQ));
+    __m256 scale = _mm256_div_ps(_mm256_set1_ps(radius), _mm256_sqrt_ps(distanceSq));
+
+    x = _mm256_blendv_ps(x, _mm256_add_ps(cx, _mm256_mul_ps(dx, scale)), inside);
+    y = _mm256_blendv_ps(y, _mm256_add_ps(cy, _mm256_mul_ps(dy, scale)), inside);
+    z = _mm256_blendv_ps(z, _mm256_add_ps(cz, _mm256_mul_ps(dz, scale)), inside);
+}
+
+__attribute__((target("avx2")))
+static inline void projectCapsule8(__m256& x, __m256& y, __m256& z, const CapsuleCollider& capsule)
+{
+    float abx, aby, abz, invLengthSq;
+    capsuleAxis(capsule, abx, aby, abz, invLengthSq);
+
+    const __m256 ax = _mm256_set1_ps(capsule.a[0]);
+    const __m256 ay = _mm256_set1_ps(capsule.a[1]);
+    const __m256 az = _mm256_set1_ps(capsule.a[2]);
+    __m256 t = _mm256_mul_ps(dot8(_mm256_sub_ps(x, ax), _mm256_sub_ps(y, ay), _mm256_sub_ps(z, az),
+                                  abx, aby, abz),
+                             _mm256_set1_ps(invLengthSq));
+    t = _mm256_min_ps(_mm256_max_ps(t, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+
+    projectSphere8(x, y, z,
+                   _mm256_add_ps(ax, _mm256_mul_ps(_mm256_set1_ps(abx), t)),
+                   _mm256_add_ps(ay, _mm256_mul_ps(_mm256_set1_ps(aby), t)),
+                   _mm256_add_ps(az, _mm256_mul_ps(_mm256_set1_ps(abz), t)), capsule.radius);
+}
+
+__attribute__((target("avx2")))
+static inline void projectBox8(__m256& x, __m256& y, __m256& z, const BoxCollider& box)
+{
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    __m256 dx = _mm256_sub_ps(x, _mm256_set1_ps(box.center[0]));
+    __m256 dy = _mm256_sub_ps(y, _mm256_set1_ps(box.center[1]));
+    __m256 dz = _mm256_sub_ps(z, _mm256_set1_ps(box.center[2]));
+
+    __m256 local[3], penetration[3];
+    for(int k = 0; k < 3; k++)
+    {
+        local[k] = dot8(dx, dy, dz, box.axes[k][0], box.axes[k][1], box.axes[k][2]);
+        penetration[k] = _mm256_sub_ps(_mm256_set1_ps(box.halfExtents[k]),
+                                       _mm256_andnot_ps(signBit, local[k]));
+    }
+
+    __m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(penetration[0], zero, _CMP_GT_OQ),
+                                                _mm256_cmp_ps(penetration[1], zero, _CMP_GT_OQ)),
+                                  _mm256_cmp_ps(penetration[2], zero, _CMP_GT_OQ));
+    __m256 useX = _mm256_and_ps(_mm256_cmp_ps(penetration[0], penetration[1], _CMP_LE_OQ),
+                                _mm256_cmp_ps(penetration[0], penetration[2], _CMP_LE_OQ));
+    __m256 useY = _mm256_andnot_ps(useX, _mm256_cmp_ps(penetration[1], penetration[2], _CMP_LE_OQ));
+
+    __m256 depth = _mm256_blendv_ps(_mm256_blendv_ps(penetration[2], penetration[1], useY),
+                                    penetration[0], useX);
+    __m256 side = _mm256_blendv_ps(_mm256_blendv_ps(local[2], local[1], useY), local[0], useX);
+    __m256 push = _mm256_or_ps(_mm256_andnot_ps(signBit, depth), _mm256_and_ps(signBit, side));
+
+    __m256* coords[3] = { &x, &y, &z };
+    for(int c = 0; c < 3; c++)
+    {
+        __m256 axis = _mm256_blendv_ps(_mm256_blendv_ps(_mm256_set1_ps(box.axes[2][c]),
+                                                        _mm256_set1_ps(box.axes[1][c]), useY),
+                                       _mm256_set1_ps(box.axes[0][c]), useX);
+        *coords[c] = _mm256_blendv_ps(*coords[c], _mm256_add_ps(*coords[c], _mm256_mul_ps(axis, push)),
+                                      inside);
+    }
+}
+
+__attribute__((target("avx2")))
+static void projectCollidersAvx2(ParticleBuffer& pos, const float* invMass,
+                                 const ColliderSet& colliders, int begin, int end)
+{
+    const __m256 zero = _mm256_setzero_ps();
+
+    int i = begin;
+    for(; i + 8 <= end; i += 8)
+    {
+        const __m256 x0 = _mm256_loadu_ps(&pos.x[i]);
+        const __m256 y0 = _mm256_loadu_ps(&pos.y[i]);
+        const __m256 z0 = _mm256_loadu_ps(&pos.z[i]);
+        __m256 x = x0, y = y0, z = z0;
+
+        for(const PlaneCollider& plane : colliders.planes)
+        {
+            projectPlane8(x, y, z, plane);
+        }
+        for(const SphereCollider& sphere : colliders.spheres)
+        {
+            projectSphere8(x, y, z, _mm256_set1_ps(sphere.center[0]), _mm256_set1_ps(sphere.center[1]),
+                           _mm256_set1_ps(sphere.center[2]), sphere.radius);
+        }
+        for(const CapsuleCollider& capsule : colliders.capsules)
+        {
+            projectCapsule8(x, y, z, capsule);
+        }
+        for(const BoxCollider& box : colliders.boxes)
+        {
+            projectBox8(x, y, z, box);
+        }
+
+        __m256 mask = _mm256_cmp_ps(_mm256_loadu_ps(invMass + i), zero, _CMP_GT_OQ);
+        _mm256_storeu_ps(&pos.x[i], _mm256_blendv_ps(x0, x, mask));
+        _mm256_storeu_ps(&pos.y[i], _mm256_blendv_ps(y0, y, mask));
+        _mm256_storeu_ps(&pos.z[i], _mm256_blendv_ps(z0, z, mask));
+    }
+
+    projectCollidersScalar(pos, invMass, colliders, i, end);
+}
+
+#endif // CLOTH_SIMD_X86
+
+//---------------------------------------------------------------------------------------
+// Runtime dispatch
+//---------------------------------------------------------------------------------------
+
+static const IntegratorKernels scalarKernels = { "scalar", accumulateForcesScalar, verletScalar,
+                                                   projectCollidersScalar };
+
+#ifdef CLOTH_SIMD_X86
+static const IntegratorKernels sse41Kernels = { "sse4.1", accumulateForcesSse41, verletSse41,
+                                                  projectCollidersSse41 };
+static const IntegratorKernels avx2Kernels = { "avx2", accumulateForcesAvx2, verletAvx2,
+                                                 projectCollidersAvx2 };
+#endif
+
+static const IntegratorKernels& selectIntegratorKernels()
+{
+#ifdef CLOTH_SIMD_X86
+    const char* forced = getenv("CLOTH_SIMD");
+    bool allowAvx2 = !forced || strcmp(forced, "avx2") == 0;
+    bool allowSse41 = allowAvx2 || strcmp(forced, "sse4.1") == 0;
+
+    __builtin_cpu_init();
+    if(allowAvx2 && __builtin_cpu_supports("avx2"))
+    {
+        return avx2Kernels;
+    }
+    if(allowSse41 && __builtin_cpu_supports("sse4.1"))
+    {
+        return sse41Kernels;
+    }
+#endif
+    return scalarKernels;
+}
+
+const IntegratorKernels& getIntegratorKernels()
+{
+    static const IntegratorKernels& kernels = selectIntegratorKernels();
+    return kernels;
+}
@@ -0,0 +1,36 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "Colliders.hpp"
+#include "ParticleBuffer.hpp"
+
+// Per-particle integration kernels. Every kernel works on the particle range
+// [begin, end) and treats particles with an inverse mass of 0 as pinned,
+// using masked blends rather than a branch per particle.
+struct IntegratorKernels {
+    const char* name;
+
+    // pos += forces * stepSize, then forces are reset, for movable particles
+    void (*accumulateForces)(ParticleBuffer& pos, ParticleBuffer& forces,
+                             const float* invMass, float stepSize,
+                             int begin, int end);
+
+    // position Verlet step: pos' = 2 * pos - oldPos + forces * stepSize^2 / m
+    void (*verlet)(ParticleBuffer& pos, ParticleBuffer& oldPos,
+                   const ParticleBuffer& forces, const float* invMass,
+                   float stepSize, int begin, int end);
+
+    // pushes movable particles out of every collider, in the order planes,
+    // spheres, capsules then boxes; all levels give the same result
+    void (*projectColliders)(ParticleBuffer& pos, const float* invMass,
+                             const ColliderSet& colliders, int begin, int end);
+};
+
+// Best kernel set for the running CPU (AVX2, SSE4.1 or scalar), picked once
+// from CPUID. The CLOTH_SIMD environment variable ("scalar", "sse4.1" or
+// "avx2") can force a lower level, e.g. to compare outputs.
+const IntegratorKernels& getIntegratorKernels();
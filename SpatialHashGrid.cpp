@@ -0,0 +1,63 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include "SpatialHashGrid.hpp"
+
+SpatialHashGrid::SpatialHashGrid()
+{
+    m_cellSize = 1.0f;
+    m_invCellSize = 1.0f;
+    m_bucketMask = 0;
+}
+
+void SpatialHashGrid::Build(const ParticleBuffer& pos, float cellSize)
+{
+    const int numParticles = pos.size();
+
+    m_cellSize = cellSize;
+    m_invCellSize = 1.0f / cellSize;
+
+    // at least 4, so the 3 cells of a row never share a bucket
+    unsigned int numBuckets = 4;
+    while(numBuckets < 2u * numParticles)
+    {
+        numBuckets *= 2;
+    }
+    m_bucketMask = numBuckets - 1;
+
+    m_bucketStart.assign(numBuckets + 1, 0);
+    m_particleBuckets.resize(numParticles);
+    m_sortedParticles.resize(numParticles);
+    m_sortedPos.resize(numParticles);
+
+    for(int i = 0; i < numParticles; i++)
+    {
+        unsigned int bucket = getBucket(getCell(pos.x[i]), getCell(pos.y[i]), getCell(pos.z[i]));
+        m_particleBuckets[i] = bucket;
+        m_bucketStart[bucket + 1]++;
+    }
+
+    for(unsigned int b = 0; b < numBuckets; b++)
+    {
+        m_bucketStart[b + 1] += m_bucketStart[b];
+    }
+
+    // scatter, using the start of each bucket as its fill cursor, which
+    // leaves it at the start of the next one; then shift the offsets back
+    for(int i = 0; i < numParticles; i++)
+    {
+        int k = m_bucketStart[m_particleBuckets[i]]++;
+        m_sortedParticles[k] = i;
+        m_sortedPos.x[k] = pos.x[i];
+        m_sortedPos.y[k] = pos.y[i];
+        m_sortedPos.z[k] = pos.z[i];
+    }
+
+    for(unsigned int b = numBuckets; b > 0; b--)
+    {
+        m_bucketStart[b] = m_bucketStart[b - 1];
+    }
+    m_bucketStart[0] = 0;
+}
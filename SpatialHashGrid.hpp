@@ -0,0 +1,124 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <math.h>
+#include <vector>
+
+#include "ParticleBuffer.hpp"
+
+// Uniform grid over unbounded space: cells are hashed into a table of about
+// twice as many buckets as particles, and particles are counting-sorted by
+// bucket so that each bucket is a contiguous range of the sorted arrays.
+// Every particle closer than the cell size to a point is in one of the 27
+// cells around it.
+//
+// Only the y and z coordinates of a cell are hashed: consecutive cells along
+// x go to consecutive buckets, so the 27 neighbour cells are 9 contiguous
+// ranges of the sorted arrays instead of 27 scattered ones.
+class SpatialHashGrid
+{
+
+public:
+
+    SpatialHashGrid();
+
+    // Buffers only grow, so rebuilding every step doesn't allocate once
+    // they are big enough. The sort is stable: particles of a bucket are in
+    // increasing index order.
+    void Build(const ParticleBuffer& pos, float cellSize);
+
+    float getCellSize() const { return m_cellSize; }
+
+    // Particle indices and positions, sorted by bucket.
+    const std::vector<int>& getSortedParticles() const { return m_sortedParticles; }
+    const ParticleBuffer& getSortedPositions() const { return m_sortedPos; }
+
+    // Calls visit(k) for each entry k of the sorted arrays that lies in one
+    // of the 27 cells around (x, y, z). Hash collisions can bring in farther
+    // particles, so callers still have to check the distance.
+    template <typename Visitor>
+    void ForEachNeighbor(float x, float y, float z, Visitor&& visit) const;
+
+private:
+
+    float m_cellSize, m_invCellSize;
+    unsigned int m_bucketMask;
+
+    std::vector<int> m_bucketStart; // numBuckets + 1 offsets into the sorted arrays
+    std::vector<int> m_particleBuckets;
+    std::vector<int> m_sortedParticles;
+    ParticleBuffer m_sortedPos;
+
+    int getCell(float v) const { return static_cast<int>(floorf(v * m_invCellSize)); }
+    unsigned int getBucket(int cx, int cy, int cz) const
+    {
+        return (((static_cast<unsigned int>(cy) * 19349663u) ^
+                 (static_cast<unsigned int>(cz) * 83492791u)) +
+                static_cast<unsigned int>(cx)) & m_bucketMask;
+    }
+};
+
+template <typename Visitor>
+void SpatialHashGrid::ForEachNeighbor(float x, float y, float z, Visitor&& visit) const
+{
+    if(m_sortedParticles.empty())
+    {
+        return;
+    }
+
+    const int cx = getCell(x), cy = getCell(y), cz = getCell(z);
+
+    // first bucket of each row of 3 cells along x
+    unsigned int rows[9];
+    int numRows = 0;
+    for(int dz = -1; dz <= 1; dz++)
+    {
+        for(int dy = -1; dy <= 1; dy++)
+        {
+            rows[numRows++] = getBucket(cx - 1, cy + dy, cz + dz);
+        }
+    }
+
+    for(int r = 0; r < 9; r++)
+    {
+        // two rows can share buckets, which must only be visited once
+        bool overlaps = false;
+        for(int s = 0; s < r; s++)
+        {
+            overlaps = overlaps || ((rows[r] - rows[s] + 2) & m_bucketMask) < 5;
+        }
+
+        if(!overlaps && rows[r] + 2 <= m_bucketMask)
+        {
+            for(int k = m_bucketStart[rows[r]]; k < m_bucketStart[rows[r] + 3]; k++)
+            {
+                visit(k);
+            }
+            continue;
+        }
+
+        for(unsigned int i = 0; i < 3; i++)
+        {
+            unsigned int bucket = (rows[r] + i) & m_bucketMask;
+
+            bool seen = false;
+            for(int s = 0; s < r; s++)
+            {
+                seen = seen || ((bucket - rows[s]) & m_bucketMask) < 3;
+            }
+            if(seen)
+            {
+                continue;
+            }
+
+            for(int k = m_bucketStart[bucket]; k < m_bucketStart[bucket + 1]; k++)
+            {
+                visit(k);
+            }
+        }
+    }
+}
@@ -0,0 +1,294 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ThreadPool.hpp"
+
+// Chunks per thread with work stealing: enough for the threads that finish
+// early to even out the load, few enough for each chunk to be worth a CAS.
+static const int chunksPerThread = 8;
+// Rounds a waiting thread yields for before it goes to sleep.
+static const int spinRounds = 256;
+
+// Pool whose tasks the current thread is running, if any.
+static thread_local const ThreadPool* t_runningPool = nullptr;
+
+static const char* const scheduleNames[] = { "static", "stealing" };
+
+bool parseThreadSchedule(const std::string& name, ThreadSchedule& schedule)
+{
+    for(unsigned int i = 0; i < sizeof(scheduleNames) / sizeof(scheduleNames[0]); i++)
+    {
+        if(name == scheduleNames[i])
+        {
+            schedule = static_cast<ThreadSchedule>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* getThreadScheduleName(ThreadSchedule schedule)
+{
+    return scheduleNames[static_cast<int>(schedule)];
+}
+
+static inline uint64_t packChunks(int begin, int end)
+{
+    return (static_cast<uint64_t>(begin) << 32) | static_cast<uint32_t>(end);
+}
+
+static inline void unpackChunks(uint64_t chunks, int& begin, int& end)
+{
+    begin = static_cast<int>(chunks >> 32);
+    end = static_cast<int>(chunks & 0xffffffffu);
+}
+
+static void pinThread(std::thread& thread, int core)
+{
+#ifdef __linux__
+    int numCores = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t cores;
+    CPU_ZERO(&cores);
+    CPU_SET(core % numCores, &cores);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cores), &cores);
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+static ThreadPoolOptions withNumThreads(int numThreads)
+{
+    ThreadPoolOptions options;
+    options.numThreads = numThreads;
+    return options;
+}
+
+ThreadPool::ThreadPool(int numThreads)
+    : ThreadPool(withNumThreads(numThreads))
+{
+}
+
+ThreadPool::ThreadPool(const ThreadPoolOptions& options)
+{
+    m_options = options;
+    m_options.numThreads = std::max(1, options.numThreads);
+    m_ranges.reset(new ChunkRange[m_options.numThreads]);
+    m_task = nullptr;
+    m_count = 0;
+    m_numChunks = 0;
+    m_generation = 0;
+    m_pending = 0;
+    m_quit = false;
+
+    for(int i = 0; i < m_options.numThreads; i++)
+    {
+        m_ranges[i].chunks = 0;
+    }
+
+    for(int i = 1; i < m_options.numThreads; i++)
+    {
+        m_workers.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+        if(m_options.pinThreads)
+        {
+            pinThread(m_workers.back(), i);
+        }
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wakeUp.notify_all();
+
+    for(unsigned int i = 0; i < m_workers.size(); i++)
+    {
+        m_workers[i].join();
+    }
+}
+
+void ThreadPool::RunChunk(int chunkIdx)
+{
+    int begin = static_cast<int>(static_cast<long long>(m_count) * chunkIdx / m_numChunks);
+    int end = static_cast<int>(static_cast<long long>(m_count) * (chunkIdx + 1) / m_numChunks);
+
+    if(begin < end)
+    {
+        (*m_task)(begin, end);
+    }
+}
+
+// Takes the upper half of another thread's chunks, runs the first of them
+// right away and keeps the rest as its own.
+bool ThreadPool::StealChunk(int threadIdx, int& chunkIdx)
+{
+    const int numThreads = m_options.numThreads;
+
+    for(int k = 1; k < numThreads; k++)
+    {
+        ChunkRange& victim = m_ranges[(threadIdx + k) % numThreads];
+        uint64_t chunks = victim.chunks.load(std::memory_order_relaxed);
+        int begin, end;
+        unpackChunks(chunks, begin, end);
+
+        while(begin < end)
+        {
+            int middle = begin + (end - begin) / 2;
+            if(victim.chunks.compare_exchange_weak(chunks, packChunks(begin, middle),
+                                                   std::memory_order_relaxed))
+            {
+                // nobody else touches an empty range, so a store is enough
+                m_ranges[threadIdx].chunks.store(packChunks(middle + 1, end), std::memory_order_relaxed);
+                chunkIdx = middle;
+                return true;
+            }
+            unpackChunks(chunks, begin, end);
+        }
+    }
+    return false;
+}
+
+void ThreadPool::RunThread(int threadIdx)
+{
+    const ThreadPool* outerPool = t_runningPool;
+    t_runningPool = this;
+    RunChunks(threadIdx);
+    t_runningPool = outerPool;
+}
+
+void ThreadPool::RunChunks(int threadIdx)
+{
+    if(m_options.schedule == ThreadSchedule::Static)
+    {
+        if(threadIdx < m_numChunks)
+        {
+            RunChunk(threadIdx);
+        }
+        return;
+    }
+
+    ChunkRange& own = m_ranges[threadIdx];
+    while(true)
+    {
+        // own chunks first, from the front, while thieves take from the back
+        uint64_t chunks = own.chunks.load(std::memory_order_relaxed);
+        int begin, end;
+        unpackChunks(chunks, begin, end);
+
+        int chunkIdx;
+        if(begin < end)
+        {
+            if(!own.chunks.compare_exchange_weak(chunks, packChunks(begin + 1, end),
+                                                 std::memory_order_relaxed))
+            {
+                continue;
+            }
+            chunkIdx = begin;
+        }
+        else if(!StealChunk(threadIdx, chunkIdx))
+        {
+            return;
+        }
+
+        RunChunk(chunkIdx);
+    }
+}
+
+void ThreadPool::WorkerLoop(int threadIdx)
+{
+    unsigned int seenGeneration = 0;
+
+    while(true)
+    {
+        for(int spin = 0; spin < spinRounds; spin++)
+        {
+            if(m_generation.load(std::memory_order_acquire) != seenGeneration)
+            {
+                break;
+            }
+            std::this_thread::yield();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeUp.wait(lock, [&] { return m_quit || m_generation != seenGeneration; });
+            if(m_quit)
+            {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        RunThread(threadIdx);
+
+        if(m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int, int)>& task, int grainSize)
+{
+    const int numThreads = m_options.numThreads;
+    const int maxChunks = m_options.schedule == ThreadSchedule::Static ? numThreads
+                                                                       : numThreads * chunksPerThread;
+    const int numChunks = std::min(maxChunks, count / std::max(1, grainSize));
+
+    // not worth waking anyone up
+    if(numThreads == 1 || numChunks < 2 || t_runningPool == this)
+    {
+        if(count > 0)
+        {
+            task(0, count);
+        }
+        return;
+    }
+
+    // the pool runs one ParallelFor at a time; other threads sharing it
+    // wait for their turn here
+    std::lock_guard<std::mutex> dispatch(m_dispatchMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_numChunks = numChunks;
+        for(int t = 0; t < numThreads; t++)
+        {
+            int first = numChunks * t / numThreads, last = numChunks * (t + 1) / numThreads;
+            m_ranges[t].chunks.store(packChunks(first, last), std::memory_order_relaxed);
+        }
+        m_pending.store(numThreads - 1, std::memory_order_relaxed);
+        m_generation.fetch_add(1, std::memory_order_release);
+    }
+    m_wakeUp.notify_all();
+
+    RunThread(0);
+
+    for(int spin = 0; spin < spinRounds; spin++)
+    {
+        if(m_pending.load(std::memory_order_acquire) == 0)
+        {
+            break;
+        }
+        std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [&] { return m_pending.load(std::memory_order_acquire) == 0; });
+    m_task = nullptr;
+}
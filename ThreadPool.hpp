@@ -0,0 +1,92 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class ThreadSchedule {
+    Static,      // one chunk per thread, always run by the same thread
+    WorkStealing // several chunks per thread; threads that run out steal from the others
+};
+
+// Command-line names of the schedules ("static", "stealing").
+// parseThreadSchedule returns false for an unknown name.
+bool parseThreadSchedule(const std::string& name, ThreadSchedule& schedule);
+const char* getThreadScheduleName(ThreadSchedule schedule);
+
+struct ThreadPoolOptions {
+    int numThreads = 1;
+    ThreadSchedule schedule = ThreadSchedule::WorkStealing;
+    // Pins worker i to core i (modulo the number of cores), so it keeps its
+    // caches from one step to the next. Best effort, Linux only; the calling
+    // thread is left alone.
+    bool pinThreads = false;
+};
+
+// Persistent pool of worker threads. The calling thread takes part in the
+// work, so a pool of N threads spawns N - 1 workers. Workers spin for a
+// short while after each ParallelFor before going to sleep, since a time
+// step issues many of them back to back.
+class ThreadPool
+{
+
+public:
+
+    explicit ThreadPool(int numThreads);
+    explicit ThreadPool(const ThreadPoolOptions& options);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator= (const ThreadPool&) = delete;
+
+    int getNumThreads() const { return m_options.numThreads; }
+    const ThreadPoolOptions& getOptions() const { return m_options; }
+
+    // Splits [0, count) into contiguous chunks of at least grainSize items
+    // and calls task(begin, end) on each of them. Returns once every chunk
+    // is done. Chunk boundaries only depend on count, grainSize, the number
+    // of threads and the schedule; with the static schedule, each chunk is
+    // also always run by the same thread. Called from inside a task of this
+    // same pool (e.g. a cloth stepped by a ClothWorld that shares its pool),
+    // it just runs the whole range on the calling thread. Calls from
+    // several other threads are safe, but run one after the other.
+    void ParallelFor(int count, const std::function<void(int, int)>& task, int grainSize = 1);
+
+private:
+
+    // chunks [begin, end) a thread has left, packed as begin << 32 | end so
+    // that the owner and thieves can update it with a single CAS
+    struct alignas(64) ChunkRange {
+        std::atomic<uint64_t> chunks;
+    };
+
+    ThreadPoolOptions m_options;
+    std::vector<std::thread> m_workers;
+    std::unique_ptr<ChunkRange[]> m_ranges;
+
+    std::mutex m_dispatchMutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp, m_done;
+    const std::function<void(int, int)>* m_task;
+    int m_count, m_numChunks;
+    std::atomic<unsigned int> m_generation;
+    std::atomic<int> m_pending;
+    bool m_quit;
+
+    void WorkerLoop(int threadIdx);
+    void RunThread(int threadIdx);
+    void RunChunks(int threadIdx);
+    void RunChunk(int chunkIdx);
+    bool StealChunk(int threadIdx, int& chunkIdx);
+};
@@ -0,0 +1,390 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+// Times each phase of ClothSimulationSystem::TimeStep on procedural cloth
+// grids of increasing size. Results are printed as one JSON object per line
+// so they can be collected and compared across builds.
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+
+#include "ClothGenerator.hpp"
+#include "ClothSimulationSystem.hpp"
+#include "SimdKernels.hpp"
+#include "Vec3.hpp"
+
+
+static const float STANDARD_TIMESTEP = 0.001f;
+
+// total particle updates each size is run for, so small grids get more steps
+static const double PARTICLE_STEPS_PER_SIZE = 2.0e7;
+static const int MIN_STEPS = 5;
+static const int MAX_STEPS = 200;
+
+
+// Square grid with a particle every unit, hanging from its top row, with
+// structural, shear and bend constraints.
+ClothGridDesc gridDesc(int side)
+{
+    ClothGridDesc desc;
+    desc.width = side;
+    desc.height = side;
+    desc.origin = Vec3f(-0.5f * side, side + 1.0f, 0.0f);
+    desc.rowAxis = Vec3f(0.0f, 0.0f, 1.0f);
+    desc.pinning = PIN_FIRST_ROW;
+    desc.shear = true;
+    desc.bend = true;
+    return desc;
+}
+
+// numColliders colliders of every kind in turn, spread across the grid the
+// way the bones of a character would be.
+void addColliders(ClothSimulationSystem& clothSystem, int side, int numColliders)
+{
+    for(int i = 0; i < numColliders; i++)
+    {
+        float u = (i + 0.5f) / numColliders;
+        Vec3f center = Vec3f((u - 0.5f) * side, 0.5f * side, 0.0f);
+        float size = 0.5f * side / numColliders;
+
+        switch(i % 4)
+        {
+            case 0:
+                clothSystem.addCollider(SphereCollider{ center, size });
+                break;
+            case 1:
+                clothSystem.addCollider(CapsuleCollider{ center - Vec3f(0.0f, size, 0.0f),
+                                                         center + Vec3f(0.0f, size, 0.0f), 0.5f * size });
+                break;
+            case 2:
+                clothSystem.addCollider(BoxCollider{ center,
+                                                     { Vec3f(1.0f, 0.0f, 0.0f), Vec3f(0.0f, 1.0f, 0.0f),
+                                                       Vec3f(0.0f, 0.0f, 1.0f) },
+                                                     Vec3f(size, size, size) });
+                break;
+            default:
+                clothSystem.addCollider(PlaneCollider{ Vec3f(0.0f, 1.0f, 0.0f), -size });
+                break;
+        }
+    }
+}
+
+// Same cloth with its particles and constraints in random order, the way
+// an arbitrary mesh exporter may number them.
+ClothSimulationSystem shuffleCloth(const ClothSimulationSystem& clothSystem)
+{
+    const int numParticles = clothSystem.getNumParticles();
+    std::mt19937 random(0);
+
+    std::vector<int> order(numParticles);
+    for(int i = 0; i < numParticles; i++)
+    {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), random);
+
+    PositionsView view = clothSystem.getPositionsView();
+    ArrayView<float> invMassView = clothSystem.getInvMassView();
+    ParticleBuffer pos;
+    FloatArray invMass(numParticles);
+    std::vector<int> newIndex(numParticles);
+    pos.resize(numParticles);
+    for(int i = 0; i < numParticles; i++)
+    {
+        pos.x[i] = view.x[order[i]];
+        pos.y[i] = view.y[order[i]];
+        pos.z[i] = view.z[order[i]];
+        invMass[i] = invMassView[order[i]];
+        newIndex[order[i]] = i;
+    }
+
+    std::vector<Constraint> constraints = clothSystem.getConstraints();
+    for(unsigned int c = 0; c < constraints.size(); c++)
+    {
+        constraints[c].idxA = newIndex[constraints[c].idxA];
+        constraints[c].idxB = newIndex[constraints[c].idxB];
+    }
+    std::shuffle(constraints.begin(), constraints.end(), random);
+
+    return ClothSimulationSystem(std::move(pos), std::move(invMass), std::move(constraints));
+}
+
+void printUsage()
+{
+    std::cout << "Usage: clothSimulationBenchmark [options]" << std::endl << std::endl;
+
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --min-particles N  smallest grid (default 1024)" << std::endl;
+    std::cout << "  --max-particles N  largest grid (default 1048576)" << std::endl;
+    std::cout << "  --steps N          timesteps per grid (default: scaled with grid size)" << std::endl;
+    std::cout << "  --solver NAME      gauss-seidel, colored, jacobi, xpbd or multigrid" << std::endl;
+    std::cout << "                     (default gauss-seidel)" << std::endl;
+    std::cout << "  --compliance C     compliance of every constraint, for xpbd (default: the scene's)" << std::endl;
+    std::cout << "  --min-iterations N relaxation passes always run per step (default 5)" << std::endl;
+    std::cout << "  --max-iterations N relaxation passes at most, with --tolerance (default: min)" << std::endl;
+    std::cout << "  --tolerance T      stop relaxing once no constraint is off by more than T (relative)" << std::endl;
+    std::cout << "  --substeps N       split each step into N substeps, each with its own relaxation" << std::endl;
+    std::cout << "                     (default 1); with --min-iterations 1, the small steps scheme" << std::endl;
+    std::cout << "  --shuffle          number particles and constraints randomly, as a mesh loader may" << std::endl;
+    std::cout << "  --reorder NAME     particle order: original, morton or rcm (default original)" << std::endl;
+    std::cout << "  --threads N        threads used by the simulation (default 1)" << std::endl;
+    std::cout << "  --schedule NAME    static or stealing (default stealing)" << std::endl;
+    std::cout << "  --pin              pin each thread to its own core" << std::endl;
+    std::cout << "  --self-collision T enable self-collision, T times the particle spacing thick" << std::endl;
+    std::cout << "  --colliders N      add N analytic colliders (spheres, capsules, boxes and planes)" << std::endl;
+}
+
+void printResult(const char* phase, unsigned int numParticles, unsigned int numConstraints,
+                 int numSteps, double totalNs)
+{
+    double nsPerStep = totalNs / numSteps;
+    double seconds = totalNs * 1.0e-9;
+
+    std::cout << "{\"phase\":\"" << phase << "\""
+              << ",\"particles\":" << numParticles
+              << ",\"constraints\":" << numConstraints
+              << ",\"steps\":" << numSteps
+              << ",\"ms_per_step\":" << nsPerStep * 1.0e-6
+              << ",\"ns_per_particle\":" << nsPerStep / numParticles
+              << ",\"particles_per_sec\":" << numParticles * static_cast<double>(numSteps) / seconds
+              << ",\"constraints_per_sec\":" << numConstraints * static_cast<double>(numSteps) / seconds
+              << "}" << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+    int minParticles = 1024;
+    int maxParticles = 1024 * 1024;
+    int fixedSteps = 0;
+    ConstraintSolver solver = ConstraintSolver::GaussSeidel;
+    int minIterations = 5;
+    int maxIterations = 0;
+    float tolerance = 0.0f;
+    float compliance = -1.0f; // negative keeps the scene's
+    int numSubsteps = 1;
+    bool shuffle = false;
+    ParticleOrdering ordering = ParticleOrdering::Original;
+    ThreadPoolOptions poolOptions;
+    float collisionThickness = 0.0f;
+    int numColliders = 0;
+
+    for(int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+
+        if(strcmp(argv[i], "--min-particles") == 0 && hasValue)
+        {
+            minParticles = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--max-particles") == 0 && hasValue)
+        {
+            maxParticles = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--steps") == 0 && hasValue)
+        {
+            fixedSteps = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--solver") == 0 && hasValue)
+        {
+            if(!parseConstraintSolver(argv[++i], solver))
+            {
+                std::cerr << "Unknown solver '" << argv[i] << "'." << std::endl;
+                return 1;
+            }
+        }
+        else if(strcmp(argv[i], "--substeps") == 0 && hasValue)
+        {
+            numSubsteps = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--compliance") == 0 && hasValue)
+        {
+            compliance = atof(argv[++i]);
+            if(!(compliance >= 0.0f))
+            {
+                std::cerr << "Compliance must be a number >= 0." << std::endl;
+                return 1;
+            }
+        }
+        else if(strcmp(argv[i], "--min-iterations") == 0 && hasValue)
+        {
+            minIterations = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--max-iterations") == 0 && hasValue)
+        {
+            maxIterations = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--tolerance") == 0 && hasValue)
+        {
+            tolerance = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--shuffle") == 0)
+        {
+            shuffle = true;
+        }
+        else if(strcmp(argv[i], "--reorder") == 0 && hasValue)
+        {
+            if(!parseParticleOrdering(argv[++i], ordering))
+            {
+                std::cerr << "Unknown particle order '" << argv[i] << "'." << std::endl;
+                return 1;
+            }
+        }
+        else if(strcmp(argv[i], "--threads") == 0 && hasValue)
+        {
+            poolOptions.numThreads = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--schedule") == 0 && hasValue)
+        {
+            if(!parseThreadSchedule(argv[++i], poolOptions.schedule))
+            {
+                std::cerr << "Unknown schedule '" << argv[i] << "'." << std::endl;
+                return 1;
+            }
+        }
+        else if(strcmp(argv[i], "--pin") == 0)
+        {
+            poolOptions.pinThreads = true;
+        }
+        else if(strcmp(argv[i], "--self-collision") == 0 && hasValue)
+        {
+            collisionThickness = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--colliders") == 0 && hasValue)
+        {
+            numColliders = atoi(argv[++i]);
+        }
+        else
+        {
+            printUsage();
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    std::cout << "{\"benchmark\":\"clothSimulation\""
+              << ",\"simd\":\"" << getIntegratorKernels().name << "\""
+              << ",\"solver\":\"" << getConstraintSolverName(solver) << "\""
+              << ",\"compliance\":" << std::max(0.0f, compliance)
+              << ",\"min_iterations\":" << minIterations
+              << ",\"max_iterations\":" << std::max(minIterations, maxIterations)
+              << ",\"tolerance\":" << tolerance
+              << ",\"substeps\":" << std::max(1, numSubsteps)
+              << ",\"shuffled\":" << (shuffle ? "true" : "false")
+              << ",\"reorder\":\"" << getParticleOrderingName(ordering) << "\""
+              << ",\"threads\":" << poolOptions.numThreads
+              << ",\"schedule\":\"" << getThreadScheduleName(poolOptions.schedule) << "\""
+              << ",\"pinned\":" << (poolOptions.pinThreads ? "true" : "false")
+              << ",\"self_collision\":" << collisionThickness
+              << ",\"colliders\":" << numColliders << "}" << std::endl;
+
+    // one pool for all the grids, as a long-running simulation server would
+    std::shared_ptr<ThreadPool> threadPool;
+    if(poolOptions.numThreads > 1)
+    {
+        threadPool = std::make_shared<ThreadPool>(poolOptions);
+    }
+
+    // grid sides are powers of 2, from ~minParticles to ~maxParticles
+    int side = 1;
+    while(side * side < minParticles)
+    {
+        side *= 2;
+    }
+
+    for(; side * side <= maxParticles; side *= 2)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ClothGridDesc desc = gridDesc(side);
+        ClothSimulationSystem clothSystem;
+        std::string error;
+        if(!generateClothGrid(desc, clothSystem, error))
+        {
+            std::cerr << "Error: " << error << "." << std::endl;
+            return 1;
+        }
+        if(shuffle)
+        {
+            clothSystem = shuffleCloth(clothSystem);
+        }
+        double generateNs = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        clothSystem.ReorderParticles(ordering);
+        double reorderNs = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+
+        clothSystem.setConstraintSolver(solver);
+        if(compliance >= 0.0f)
+        {
+            clothSystem.setConstraintCompliance(compliance);
+        }
+        clothSystem.setRelaxationIterations(minIterations, std::max(minIterations, maxIterations), tolerance);
+        clothSystem.setSubsteps(numSubsteps);
+        clothSystem.setThreadPool(threadPool);
+        clothSystem.setSelfCollision(collisionThickness > 0.0f, collisionThickness * desc.spacing);
+        addColliders(clothSystem, side, numColliders);
+
+        unsigned int numParticles = clothSystem.getNumParticles();
+        unsigned int numConstraints = clothSystem.getNumConstraints();
+
+        int numSteps = fixedSteps;
+        if(numSteps <= 0)
+        {
+            numSteps = static_cast<int>(PARTICLE_STEPS_PER_SIZE / numParticles);
+            numSteps = std::min(MAX_STEPS, std::max(MIN_STEPS, numSteps));
+        }
+
+        Vec3f gravity = Vec3f(0.0f, -9.81f, 0.0f);
+        StepTimings total;
+        long long totalIterations = 0;
+
+        for(int step = 0; step < numSteps; step++)
+        {
+            clothSystem.ApplyForce(gravity);
+            clothSystem.TimeStep(STANDARD_TIMESTEP);
+
+            const StepTimings& timings = clothSystem.getLastStepTimings();
+            total.accumulateForcesNs += timings.accumulateForcesNs;
+            total.verletNs += timings.verletNs;
+            total.collisionDetectionNs += timings.collisionDetectionNs;
+            total.satisfyConstraintsNs += timings.satisfyConstraintsNs;
+            total.collidersNs += timings.collidersNs;
+            totalIterations += clothSystem.getLastSolverStats().iterations;
+        }
+
+        double stepNs = total.accumulateForcesNs + total.verletNs +
+                        total.collisionDetectionNs + total.satisfyConstraintsNs;
+
+        printResult("generate", numParticles, numConstraints, 1, generateNs);
+        if(ordering != ParticleOrdering::Original)
+        {
+            printResult("reorder", numParticles, numConstraints, 1, reorderNs);
+        }
+        printResult("accumulate_forces", numParticles, numConstraints, numSteps, total.accumulateForcesNs);
+        printResult("verlet", numParticles, numConstraints, numSteps, total.verletNs);
+        if(clothSystem.getSelfCollision())
+        {
+            printResult("collision_detection", numParticles, numConstraints, numSteps, total.collisionDetectionNs);
+        }
+        printResult("satisfy_constraints", numParticles, numConstraints, numSteps, total.satisfyConstraintsNs);
+        if(numColliders > 0)
+        {
+            // included in satisfy_constraints, once per relaxation iteration
+            printResult("colliders", numParticles, numConstraints, numSteps, total.collidersNs);
+        }
+        printResult("time_step", numParticles, numConstraints, numSteps, stepNs);
+        std::cout << "{\"phase\":\"relaxation\""
+                  << ",\"particles\":" << numParticles
+                  << ",\"iterations_per_step\":" << static_cast<double>(totalIterations) / numSteps
+                  << "}" << std::endl;
+    }
+
+    return 0;
+}
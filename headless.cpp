@@ -0,0 +1,410 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+// Batch driver: runs a scene for a fixed number of steps without any window
+// or OpenGL context, and writes the positions and step timings to disk.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ClothScenes.hpp"
+#include "ClothSimulationSystem.hpp"
+#include "ClothWorld.hpp"
+#include "CollisionMesh.hpp"
+#include "FrameCache.hpp"
+#include "ObjLoader.hpp"
+#include "Profiler.hpp"
+#include "SceneFile.hpp"
+#include "Vec3.hpp"
+
+
+static const float STANDARD_TIMESTEP = 0.001f;
+
+
+void printUsage()
+{
+    std::cout << "Usage: clothSimulationHeadless <scene|file.cloth> [options]" << std::endl << std::endl;
+
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --steps N          number of timesteps to run (default 1000)" << std::endl;
+    std::cout << "  --dt DT            timestep in seconds (default " << STANDARD_TIMESTEP << ")" << std::endl;
+    std::cout << "  --wind             apply random wind force" << std::endl;
+    std::cout << "  --seed S           random seed used by the wind (default 0)" << std::endl;
+    std::cout << "  --solver NAME      gauss-seidel, colored, jacobi, xpbd or multigrid" << std::endl;
+    std::cout << "                     (default gauss-seidel)" << std::endl;
+    std::cout << "  --compliance C     compliance of every constraint, for xpbd (default: the scene's)" << std::endl;
+    std::cout << "  --min-iterations N relaxation passes always run per step (default 5)" << std::endl;
+    std::cout << "  --max-iterations N relaxation passes at most, with --tolerance (default: min)" << std::endl;
+    std::cout << "  --tolerance T      stop relaxing once no constraint is off by more than T (relative)" << std::endl;
+    std::cout << "  --substeps N       split each step into N substeps, each with its own relaxation" << std::endl;
+    std::cout << "                     (default 1); with --min-iterations 1, the small steps scheme" << std::endl;
+    std::cout << "  --reorder NAME     particle order: original, morton or rcm (default original)" << std::endl;
+    std::cout << "  --threads N        threads used by the simulation (default 1)" << std::endl;
+    std::cout << "  --schedule NAME    static or stealing (default stealing)" << std::endl;
+    std::cout << "  --pin              pin each thread to its own core" << std::endl;
+    std::cout << "  --copies N         step N independent copies of the scene concurrently (default 1)" << std::endl;
+    std::cout << "  --self-collision T keep particles at least T apart" << std::endl;
+    std::cout << "  --collision-mesh F collide with the triangle mesh of an .obj file" << std::endl;
+    std::cout << "  --mesh-thickness T distance kept from the collision mesh (default 0.02)" << std::endl;
+    std::cout << "  --output FILE      write positions to FILE" << std::endl;
+    std::cout << "  --every K          write positions every K steps (default: last step only)" << std::endl;
+    std::cout << "  --timing FILE      write per-step timings (csv) to FILE" << std::endl;
+    std::cout << "  --profile FILE     print per-phase p50/p99 and write a Chrome trace to FILE" << std::endl;
+    std::cout << "                     (builds with CXXFLAGS=-DCLOTH_ENABLE_PROFILING only)" << std::endl;
+    std::cout << "  --cache FILE       stream positions to a binary frame cache (every step, or every K)" << std::endl;
+    std::cout << "  --cache-encoding E raw, quantized or delta (default raw)" << std::endl;
+    std::cout << "  --keyframes K      keyframe interval of delta caches (default 30)" << std::endl << std::endl;
+
+    std::cout << "Scenes:" << std::endl;
+    int numScenes;
+    const ClothScene* scenes = getClothScenes(numScenes);
+    for(int i = 0; i < numScenes; i++)
+    {
+        std::cout << "  " << scenes[i].name << std::endl;
+    }
+}
+
+void writeFrame(std::ofstream& output, int step, const std::vector<Vec3f>& pos)
+{
+    output << "frame " << step << " " << pos.size() << "\n";
+    for(unsigned int i = 0; i < pos.size(); i++)
+    {
+        output << pos[i] << "\n";
+    }
+}
+
+int main (int argc, char ** argv)
+{
+    if(argc < 2 || strcmp(argv[1], "--help") == 0)
+    {
+        printUsage();
+        return argc < 2 ? 1 : 0;
+    }
+
+    // anything that isn't a built-in scene name is loaded as a scene file
+    const ClothScene* scene = findClothScene(argv[1]);
+    ClothSimulationSystem clothSystem;
+    std::string error;
+    if(scene)
+    {
+        clothSystem = scene->create();
+    }
+    else if(!loadSceneFile(argv[1], clothSystem, error))
+    {
+        std::cerr << "Unknown scene '" << argv[1] << "' (" << error << ")." << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    int numSteps = 1000;
+    float deltaTime = STANDARD_TIMESTEP;
+    bool wind = false;
+    unsigned int seed = 0;
+    ConstraintSolver solver = ConstraintSolver::GaussSeidel;
+    int minIterations = 5;
+    int maxIterations = 0;
+    float tolerance = 0.0f;
+    float compliance = -1.0f; // negative keeps the scene's
+    int numSubsteps = 1;
+    ParticleOrdering ordering = ParticleOrdering::Original;
+    ThreadPoolOptions poolOptions;
+    int numCopies = 1;
+    float collisionThickness = 0.0f;
+    const char* meshPath = nullptr;
+    float meshThickness = 0.02f;
+    const char* outputPath = nullptr;
+    int outputEvery = 0;
+    const char* timingPath = nullptr;
+    const char* profilePath = nullptr;
+    const char* cachePath = nullptr;
+    FrameCacheOptions cacheOptions;
+
+    for(int i = 2; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+
+        if(strcmp(argv[i], "--wind") == 0)
+        {
+            wind = true;
+        }
+        else if(strcmp(argv[i], "--steps") == 0 && hasValue)
+        {
+            numSteps = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--dt") == 0 && hasValue)
+        {
+            deltaTime = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--seed") == 0 && hasValue)
+        {
+            seed = strtoul(argv[++i], nullptr, 10);
+        }
+        else if(strcmp(argv[i], "--solver") == 0 && hasValue)
+        {
+            if(!parseConstraintSolver(argv[++i], solver))
+            {
+                std::cerr << "Unknown solver '" << argv[i] << "'." << std::endl;
+                return 1;
+            }
+        }
+        else if(strcmp(argv[i], "--substeps") == 0 && hasValue)
+        {
+            numSubsteps = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--compliance") == 0 && hasValue)
+        {
+            compliance = atof(argv[++i]);
+            if(!(compliance >= 0.0f))
+            {
+                std::cerr << "Compliance must be a number >= 0." << std::endl;
+                return 1;
+            }
+        }
+        else if(strcmp(argv[i], "--min-iterations") == 0 && hasValue)
+        {
+            minIterations = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--max-iterations") == 0 && hasValue)
+        {
+            maxIterations = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--tolerance") == 0 && hasValue)
+        {
+            tolerance = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--reorder") == 0 && hasValue)
+        {
+            if(!parseParticleOrdering(argv[++i], ordering))
+            {
+                std::cerr << "Unknown particle order '" << argv[i] << "'." << std::endl;
+                return 1;
+            }
+        }
+        else if(strcmp(argv[i], "--threads") == 0 && hasValue)
+        {
+            poolOptions.numThreads = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--schedule") == 0 && hasValue)
+        {
+            if(!parseThreadSchedule(argv[++i], poolOptions.schedule))
+            {
+                std::cerr << "Unknown schedule '" << argv[i] << "'." << std::endl;
+                return 1;
+            }
+        }
+        else if(strcmp(argv[i], "--pin") == 0)
+        {
+            poolOptions.pinThreads = true;
+        }
+        else if(strcmp(argv[i], "--copies") == 0 && hasValue)
+        {
+            numCopies = std::max(1, atoi(argv[++i]));
+        }
+        else if(strcmp(argv[i], "--self-collision") == 0 && hasValue)
+        {
+            collisionThickness = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--collision-mesh") == 0 && hasValue)
+        {
+            meshPath = argv[++i];
+        }
+        else if(strcmp(argv[i], "--mesh-thickness") == 0 && hasValue)
+        {
+            meshThickness = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--output") == 0 && hasValue)
+        {
+            outputPath = argv[++i];
+        }
+        else if(strcmp(argv[i], "--every") == 0 && hasValue)
+        {
+            outputEvery = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--timing") == 0 && hasValue)
+        {
+            timingPath = argv[++i];
+        }
+        else if(strcmp(argv[i], "--profile") == 0 && hasValue)
+        {
+            profilePath = argv[++i];
+        }
+        else if(strcmp(argv[i], "--cache") == 0 && hasValue)
+        {
+            cachePath = argv[++i];
+        }
+        else if(strcmp(argv[i], "--cache-encoding") == 0 && hasValue)
+        {
+            i++;
+            if(strcmp(argv[i], "raw") == 0)
+            {
+                cacheOptions.encoding = FRAME_CACHE_RAW;
+            }
+            else if(strcmp(argv[i], "quantized") == 0)
+            {
+                cacheOptions.encoding = FRAME_CACHE_QUANTIZED;
+            }
+            else if(strcmp(argv[i], "delta") == 0)
+            {
+                cacheOptions.encoding = FRAME_CACHE_QUANTIZED_DELTA;
+            }
+            else
+            {
+                std::cerr << "Unknown cache encoding '" << argv[i] << "'." << std::endl;
+                return 1;
+            }
+        }
+        else if(strcmp(argv[i], "--keyframes") == 0 && hasValue)
+        {
+            cacheOptions.keyframeInterval = atoi(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option '" << argv[i] << "'." << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::ofstream output, timing;
+    if(outputPath)
+    {
+        output.open(outputPath);
+        if(!output)
+        {
+            std::cerr << "Can't open '" << outputPath << "' for writing." << std::endl;
+            return 1;
+        }
+    }
+    if(timingPath)
+    {
+        timing.open(timingPath);
+        if(!timing)
+        {
+            std::cerr << "Can't open '" << timingPath << "' for writing." << std::endl;
+            return 1;
+        }
+        timing << "step,ms,iterations\n";
+    }
+
+    FrameCacheWriter cache;
+    if(cachePath && !cache.Open(cachePath, clothSystem.getNumParticles(), cacheOptions, error))
+    {
+        std::cerr << "Error: " << error << "." << std::endl;
+        return 1;
+    }
+
+    if(meshPath)
+    {
+        std::vector<Vec3f> vertices;
+        std::vector<int> triangles;
+        if(!loadObj(meshPath, vertices, triangles, error))
+        {
+            std::cerr << "Error: " << error << "." << std::endl;
+            return 1;
+        }
+        clothSystem.addCollisionMesh(std::make_shared<CollisionMesh>(vertices, triangles), meshThickness);
+    }
+
+    srand(seed);
+
+    clothSystem.ReorderParticles(ordering);
+    clothSystem.setConstraintSolver(solver);
+    if(compliance >= 0.0f)
+    {
+        clothSystem.setConstraintCompliance(compliance);
+    }
+    clothSystem.setRelaxationIterations(minIterations, std::max(minIterations, maxIterations), tolerance);
+    clothSystem.setSubsteps(numSubsteps);
+    clothSystem.setSelfCollision(collisionThickness > 0.0f, collisionThickness);
+
+    // the copies are stepped independently; only the first one is written out
+    ClothWorld world;
+    for(int c = 0; c < numCopies; c++)
+    {
+        world.AddCloth(ClothSimulationSystem(clothSystem));
+    }
+    if(poolOptions.numThreads > 1)
+    {
+        world.setThreadPool(std::make_shared<ThreadPool>(poolOptions));
+    }
+    const ClothSimulationSystem& firstCloth = world.getCloth(0);
+
+    std::cout << "Running " << (scene ? scene->description : argv[1]);
+    if(numCopies > 1)
+    {
+        std::cout << " (" << numCopies << " copies)";
+    }
+    std::cout << " for " << numSteps << " steps of " << deltaTime << "s." << std::endl;
+    if(solver == ConstraintSolver::Multigrid)
+    {
+        std::cout << "Multigrid solver with " << firstCloth.getNumCoarseLevels() << " coarse levels." << std::endl;
+    }
+
+    std::vector<Vec3f> snapshot;
+    double totalMs = 0.0;
+    long long totalIterations = 0;
+    for(int step = 1; step <= numSteps; step++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        stepScene(world, deltaTime, wind);
+        auto end = std::chrono::steady_clock::now();
+
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        totalMs += ms;
+        totalIterations += firstCloth.getLastSolverStats().iterations;
+
+        if(timingPath)
+        {
+            timing << step << "," << ms << "," << firstCloth.getLastSolverStats().iterations << "\n";
+        }
+        if(outputPath && ((outputEvery > 0 && step % outputEvery == 0) || step == numSteps))
+        {
+            firstCloth.getPos(snapshot);
+            writeFrame(output, step, snapshot);
+        }
+        if(cachePath && (outputEvery <= 0 || step % outputEvery == 0))
+        {
+            cache.PushFrame(firstCloth, step * deltaTime);
+        }
+    }
+
+    if(cachePath && !cache.Close(error))
+    {
+        std::cerr << "Error: " << error << "." << std::endl;
+        return 1;
+    }
+    if(cachePath && cache.getNumStalls() > 0)
+    {
+        std::cout << "Waited " << cache.getNumStalls() << " times for the cache to be written"
+                  << " (more than " << cacheOptions.maxQueuedFrames << " frames behind)." << std::endl;
+    }
+
+    std::cout << "Done in " << totalMs << " ms ("
+              << (numSteps > 0 ? totalMs / numSteps : 0.0) << " ms/step)." << std::endl;
+    if(tolerance > 0.0f && numSteps > 0)
+    {
+        const SolverStats& stats = firstCloth.getLastSolverStats();
+        std::cout << "Relaxation passes: " << static_cast<double>(totalIterations) / numSteps
+                  << " per step (last step: " << stats.iterations << ", max violation "
+                  << stats.maxViolation << ", rms " << stats.rmsViolation << ")." << std::endl;
+    }
+
+    if(profilePath)
+    {
+        printProfileReport(std::cout);
+        if(isProfilingEnabled() && !writeChromeTrace(profilePath, error))
+        {
+            std::cerr << "Error: " << error << "." << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+//-----------------------------------------------------------------------------
+// Author: Bernard Lupiac
+// Created: 17/10/2026
+//-----------------------------------------------------------------------------
+
+// Converts OBJ triangle meshes (or one of the built-in example scenes) to
+// binary .cloth scene files. Every mesh edge becomes a constraint whose rest
+// length is its length in the mesh.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <iostream>
+
+#include "ClothScenes.hpp"
+#include "ObjLoader.hpp"
+#include "SceneFile.hpp"
+
+
+void printUsage()
+{
+    std::cout << "Usage: clothSceneConverter <input.obj> <output.cloth> [options]" << std::endl;
+    std::cout << "       clothSceneConverter --scene <name> <output.cloth>" << std::endl << std::endl;
+
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --scale S          scale the mesh by S" << std::endl;
+    std::cout << "  --pin-above Y      pin the vertices at or above height Y" << std::endl;
+    std::cout << "  --pin-top EPS      pin the vertices within EPS of the highest one" << std::endl;
+    std::cout << "  --bend             add bend constraints across every inner edge" << std::endl;
+}
+
+struct Edge {
+    int idxA, idxB;  // idxA < idxB
+    int opposite;    // third vertex of the triangle the edge comes from
+
+    bool operator< (const Edge& e) const
+    {
+        return idxA != e.idxA ? idxA < e.idxA : idxB < e.idxB;
+    }
+};
+
+float distance(const std::vector<Vec3f>& vertices, int idxA, int idxB)
+{
+    Vec3f delta = vertices[idxB] - vertices[idxA];
+    return sqrt(delta.dot(delta));
+}
+
+void addConstraint(std::vector<Constraint>& constraints, const std::vector<Vec3f>& vertices,
+                   int idxA, int idxB)
+{
+    Constraint c;
+    c.idxA = idxA;
+    c.idxB = idxB;
+    c.restlength = distance(vertices, idxA, idxB);
+    constraints.push_back(c);
+}
+
+void buildConstraints(const std::vector<Vec3f>& vertices, const std::vector<int>& triangles,
+                      bool bend, std::vector<Constraint>& constraints)
+{
+    std::vector<Edge> edges;
+    edges.reserve(triangles.size());
+
+    for(unsigned int t = 0; t + 2 < triangles.size(); t += 3)
+    {
+        for(int k = 0; k < 3; k++)
+        {
+            Edge e;
+            e.idxA = std::min(triangles[t + k], triangles[t + (k + 1) % 3]);
+            e.idxB = std::max(triangles[t + k], triangles[t + (k + 1) % 3]);
+            e.opposite = triangles[t + (k + 2) % 3];
+            edges.push_back(e);
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+
+    constraints.clear();
+    constraints.reserve(edges.size() / 2);
+
+    // edges shared by two triangles come out next to each other
+    for(unsigned int i = 0; i < edges.size(); i++)
+    {
+        if(edges[i].idxA == edges[i].idxB)
+        {
+            continue; // degenerate triangle
+        }
+        if(i == 0 || edges[i - 1] < edges[i])
+        {
+            addConstraint(constraints, vertices, edges[i].idxA, edges[i].idxB);
+        }
+        else if(bend && edges[i - 1].opposite != edges[i].opposite)
+        {
+            addConstraint(constraints, vertices, edges[i - 1].opposite, edges[i].opposite);
+        }
+    }
+}
+
+int main (int argc, char ** argv)
+{
+    if(argc < 3)
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::string error;
+
+    if(strcmp(argv[1], "--scene") == 0)
+    {
+        const ClothScene* scene = findClothScene(argv[2]);
+        if(!scene || argc < 4)
+        {
+            printUsage();
+            return 1;
+        }
+        if(!saveSceneFile(argv[3], scene->create(), error))
+        {
+            std::cerr << "Error: " << error << "." << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    float scale = 1.0f;
+    bool pinAbove = false, pinTop = false, bend = false;
+    float pinHeight = 0.0f, pinEpsilon = 0.0f;
+
+    for(int i = 3; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+
+        if(strcmp(argv[i], "--scale") == 0 && hasValue)
+        {
+            scale = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--pin-above") == 0 && hasValue)
+        {
+            pinAbove = true;
+            pinHeight = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--pin-top") == 0 && hasValue)
+        {
+            pinTop = true;
+            pinEpsilon = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--bend") == 0)
+        {
+            bend = true;
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::vector<Vec3f> vertices;
+    std::vector<int> triangles;
+    if(!loadObj(argv[1], vertices, triangles, error))
+    {
+        std::cerr << "Error: " << error << "." << std::endl;
+        return 1;
+    }
+
+    float maxHeight = -INFINITY;
+    for(unsigned int i = 0; i < vertices.size(); i++)
+    {
+        vertices[i] = vertices[i] * scale;
+        maxHeight = std::max(maxHeight, vertices[i][1]);
+    }
+
+    ParticleBuffer pos;
+    FloatArray invMass;
+    pos.resize(vertices.size());
+    invMass.resize(vertices.size());
+
+    int numPinned = 0;
+    for(unsigned int i = 0; i < vertices.size(); i++)
+    {
+        pos.x[i] = vertices[i][0];
+        pos.y[i] = vertices[i][1];
+        pos.z[i] = vertices[i][2];
+
+        bool pinned = (pinAbove && vertices[i][1] >= pinHeight) ||
+                      (pinTop && vertices[i][1] >= maxHeight - pinEpsilon);
+        invMass[i] = pinned ? 0.0f : 1.0f;
+        numPinned += pinned;
+    }
+
+    std::vector<Constraint> constraints;
+    buildConstraints(vertices, triangles, bend, constraints);
+
+    if(!saveSceneFile(argv[2], pos, invMass, constraints, error))
+    {
+        std::cerr << "Error: " << error << "." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << vertices.size() << " particles (" << numPinned << " pinned) and "
+              << constraints.size() << " constraints to " << argv[2] << "." << std::endl;
+    return 0;
+}